@@ -4,8 +4,23 @@
 */
 
 #include <iostream>
+#include <cstring>
 #include "Eigen/Dense"
 #include "Hamming.h"
+#include "HammingLatency.h"
+#include "HammingMetrics.h"
+
+namespace {
+    //Eight bytes as a little-endian integer on any host
+    std::uint64_t loadLittle64(const char* bytes) {
+        std::uint64_t value;
+        std::memcpy(&value, bytes, sizeof(value));
+#if __BYTE_ORDER__ == __ORDER_BIG_ENDIAN__
+        value = __builtin_bswap64(value);
+#endif
+        return value;
+    }
+}
 
 Hamming::Hamming(std::string file) : generator(7,4), parityCheck(3,7) {
 
@@ -25,6 +40,7 @@ Hamming::Hamming(std::string file) : generator(7,4), parityCheck(3,7) {
 
 
     fileName = file;
+    buildTables();
 }
 
 Hamming::~Hamming() {}
@@ -35,4 +51,162 @@ void Hamming::printOut() const {
     std::cout << "Parity Check Matrix:\n" << parityCheck << "\n\n";
 }
 
+//Precompute every codeword once so byte-oriented formats don't need a matrix product per block
+void Hamming::buildTables() {
+    for (int msg = 0; msg < 16; ++msg) {
+        Eigen::Matrix<int, 1, 4> message;
+        for (int i = 0; i < 4; ++i) message(0, i) = (msg >> (3 - i)) & 1;
+
+        Eigen::Matrix<int, 1, 7> code = message * generator.transpose();
+        int packed = 0;
+        for (int j = 0; j < 7; ++j) packed = (packed << 1) | (code(0, j) % 2);
+        encodeTable[msg] = static_cast<unsigned char>(packed);
+    }
+
+    for (int word = 0; word < 128; ++word) {
+        Eigen::Matrix<int, 1, 7> block;
+        for (int j = 0; j < 7; ++j) block(0, j) = (word >> (6 - j)) & 1;
+
+        Eigen::Matrix<int, 1, 3> parity = block * parityCheck.transpose();
+        int errorPosition = ((parity(0, 2) % 2) << 2) | ((parity(0, 1) % 2) << 1) | (parity(0, 0) % 2);
+        syndromeTable[word] = static_cast<unsigned char>(errorPosition);
+        for (int j = 0; j < 7; ++j) codewordText[word][j] = static_cast<char>('0' + block(0, j));
+        codewordText[word][7] = '\0';
+
+        if (errorPosition > 0) block(0, errorPosition - 1) ^= 1;
+        correctTable[word] = static_cast<unsigned char>((block(0, 2) << 3) | (block(0, 4) << 2) | (block(0, 5) << 1) | block(0, 6));
+    }
+
+    //Bit-sliced form of the generator matrix and the syndrome table
+    for (int j = 0; j < 7; ++j) {
+        sliceEncodeMask[j] = 0;
+        for (int i = 0; i < 4; ++i) {
+            if (generator(j, i) % 2) sliceEncodeMask[j] |= static_cast<unsigned char>(8 >> i);
+        }
+        for (int i = 0; i < 4; ++i) {
+            if (sliceEncodeMask[j] == (8 >> i)) sliceDataColumn[i] = j;
+        }
+        sliceSyndrome[j] = syndromeTable[0x40 >> j];
+    }
+    for (int r = 0; r < 3; ++r) {
+        sliceCheckMask[r] = 0;
+        for (int j = 0; j < 7; ++j) {
+            if (parityCheck(r, j) % 2) sliceCheckMask[r] |= static_cast<unsigned char>(0x40 >> j);
+        }
+    }
+}
+
+//Column j of 64 codewords is one 64-bit word, so every logic operation handles 64 blocks
+void Hamming::encodeSliced(const std::uint64_t message[4], std::uint64_t word[7]) const {
+    for (int j = 0; j < 7; ++j) {
+        std::uint64_t column = 0;
+        for (int i = 0; i < 4; ++i) {
+            if (sliceEncodeMask[j] & (8 >> i)) column ^= message[i];
+        }
+        word[j] = column;
+    }
+}
+
+void Hamming::correctSliced(std::uint64_t word[7]) const {
+    std::uint64_t syndrome[3];
+    for (int r = 0; r < 3; ++r) {
+        syndrome[r] = 0;
+        for (int j = 0; j < 7; ++j) {
+            if (sliceCheckMask[r] & (0x40 >> j)) syndrome[r] ^= word[j];
+        }
+    }
+
+    //Flip column j in every lane whose syndrome is the syndrome of an error in column j
+    for (int j = 0; j < 7; ++j) {
+        std::uint64_t match = ~static_cast<std::uint64_t>(0);
+        for (int r = 0; r < 3; ++r) match &= ((sliceSyndrome[j] >> r) & 1) ? syndrome[r] : ~syndrome[r];
+        word[j] ^= match;
+    }
+}
+
+//Shared text encoder; one record per byte, newlines are dropped just like Encode::processFile
+std::size_t Hamming::encodeToText(const char* in, std::size_t length, char* out) const {
+    LatencyScope latency(LatencyOp::Encode);
+    char* start = out;
+    for (std::size_t i = 0; i < length; ++i) {
+        unsigned char ch = static_cast<unsigned char>(in[i]);
+        if (ch == '\n') continue;
+
+        std::memcpy(out, codewordText[encodeTable[ch >> 4]], 7);
+        std::memcpy(out + 7, codewordText[encodeTable[ch & 0x0F]], 7);
+        out[14] = '\n';
+        out += 15;
+    }
+    std::size_t written = static_cast<std::size_t>(out - start);
+    Metrics::count(length, written, written / 15 * 2);
+    return written;
+}
+
+//Shared text decoder; lines that are not exactly 14 binary digits produce no output, and like
+//Decode::processFile only the non-empty ones count as malformed
+//Counters live in a local copy (out is a char*, so stores through it could alias a caller's
+//DecodeStats and would force them back to memory every record) and are merged once at the end
+std::size_t Hamming::decodeFromText(const char* in, std::size_t length, char* out, DecodeStats& stats) const {
+    LatencyScope latency(LatencyOp::Decode);
+    const char* end = in + length;
+    char* start = out;
+    DecodeStats local;
+    std::size_t clean = 0;  //Error-free blocks of the fast path, kept out of the histogram until the end
+    while (in < end) {
+        //Fast path: a whole well-formed record, 14 digits and its newline, needs no search. Each
+        //codeword's 7 digits come from one 8-byte load: they are digits if every byte is 0x30 or
+        //0x31, and one multiply gathers the low bit of byte i into bit 6 - i of the top byte. A window
+        //that fails may hold several short lines, so it is left to the line-by-line path below
+        if (end - in >= 15 && in[14] == '\n') {
+            const std::uint64_t digitBytes = 0x00FFFFFFFFFFFFFF, zeros = 0x0030303030303030;
+            const std::uint64_t lowBits = 0x0001010101010101, gather = 0x4020100804020100;
+            std::uint64_t first = loadLittle64(in) & digitBytes, second = loadLittle64(in + 7) & digitBytes;
+            if ((first & ~lowBits) == zeros && (second & ~lowBits) == zeros) {
+                unsigned high = static_cast<unsigned>(((first & lowBits) * gather) >> 56) & 0x7F;
+                unsigned low = static_cast<unsigned>(((second & lowBits) * gather) >> 56) & 0x7F;
+                unsigned highSyndrome = syndromeTable[high], lowSyndrome = syndromeTable[low];
+                if (highSyndrome | lowSyndrome) {
+                    local.record(highSyndrome);
+                    local.record(lowSyndrome);
+                } else {
+                    clean += 2;
+                }
+                *out++ = static_cast<char>((correctTable[high] << 4) | correctTable[low]);
+                in += 15;
+                continue;
+            }
+        }
+
+        const char* newline = static_cast<const char*>(std::memchr(in, '\n', static_cast<std::size_t>(end - in)));
+        const char* lineEnd = newline ? newline : end;
+        if (lineEnd == in) {
+            in = newline + 1;
+            continue;
+        }
+
+        bool valid = (lineEnd - in == 14);
+        unsigned words[2] = {0, 0};
+        for (int i = 0; valid && i < 14; ++i) {
+            unsigned bit = static_cast<unsigned>(in[i] - '0');
+            valid = bit <= 1;
+            words[i / 7] = (words[i / 7] << 1) | bit;
+        }
+
+        if (valid) {
+            local.record(syndromeTable[words[0]]);
+            local.record(syndromeTable[words[1]]);
+            *out++ = static_cast<char>((correctTable[words[0]] << 4) | correctTable[words[1]]);
+        } else {
+            ++local.malformed;
+        }
+
+        in = newline ? newline + 1 : end;
+    }
+    local.blocks += clean;
+    local.positions[0] += clean;
+    stats.merge(local);
+    Metrics::count(length, static_cast<std::size_t>(out - start), local.blocks, local.corrected);
+    return static_cast<std::size_t>(out - start);
+}
+
 void processFile() {}
@@ -5,12 +5,70 @@
 #ifndef HAMMING_H
 #define HAMMING_H
 
+#include <array>
+#include <cstdint>
 #include <fstream>
 #include <iostream>
 #include <string>
 #include <vector>
 #include "Eigen/Dense"
 
+class ThreadPool;
+class ErrorMap;
+class FaultMapReader;
+
+/**
+ * @struct DecodeStats
+ * @brief Correction counters gathered while decoding.
+ *
+ * Decoders fill these with a few increments per codeword instead of printing per block, and
+ * report them once at the end. Every 3-bit syndrome of Hamming(7,4) names a bit position, so a
+ * double error is "corrected" into a wrong codeword and cannot be detected by the code itself;
+ * only the packed container's per-chunk CRC32C reports blocks as uncorrectable.
+ */
+struct DecodeStats {
+    std::size_t blocks = 0;          ///< 7-bit blocks decoded
+    std::size_t corrected = 0;       ///< Blocks with a non-zero syndrome that were corrected
+    std::size_t uncorrectable = 0;   ///< Blocks in a packed chunk whose CRC32C failed after correction
+    std::size_t malformed = 0;       ///< Non-empty lines skipped because they were not 14 binary digits (blank lines are ignored)
+    std::size_t positions[8] = {};   ///< Blocks per syndrome: [0] clean, [p] corrected at bit position p (1-based column)
+
+    /**
+     * @brief Counts one decoded block.
+     * @param syndrome Its error position (1-based) or 0 if no error.
+     */
+    void record(unsigned syndrome) {
+        ++blocks;
+        corrected += syndrome != 0;
+        ++positions[syndrome & 7];
+    }
+
+    /**
+     * @brief Adds another set of counters into this one.
+     * @param other The counters to add.
+     */
+    void merge(const DecodeStats& other) {
+        blocks += other.blocks;
+        corrected += other.corrected;
+        uncorrectable += other.uncorrectable;
+        malformed += other.malformed;
+        for (int p = 0; p < 8; ++p) positions[p] += other.positions[p];
+    }
+
+    /**
+     * @brief Prints the counters as one summary line, plus the corrections per bit position if there were any.
+     * @param out Destination stream.
+     */
+    void print(std::ostream& out) const {
+        out << blocks << " blocks, " << corrected << " corrected, " << uncorrectable << " uncorrectable, " << malformed << " malformed lines.";
+        if (corrected) {
+            out << " Corrections by bit position:";
+            for (int p = 1; p < 8; ++p) out << " " << p << ":" << positions[p];
+            out << ".";
+        }
+    }
+};
+
 /**
  * @class Hamming
  * @brief Base class for handling Hamming codes.
@@ -41,6 +99,53 @@ class Hamming {
         Eigen::Matrix<int, 3, 7> parityCheck; ///< Hamming parity check matrix (3x7)
         std::string fileName; ///< Name of the file being processed
 
+        unsigned char encodeTable[16];    ///< 4-bit message -> 7-bit codeword (bit 6 holds column 0)
+        unsigned char correctTable[128];  ///< 7-bit codeword -> corrected 4-bit message
+        unsigned char syndromeTable[128]; ///< 7-bit codeword -> error position (1-based) or 0 if no error
+        char codewordText[128][8];        ///< 7-bit codeword -> its 7 binary digits as text
+
+        unsigned char sliceEncodeMask[7];  ///< Bit-sliced code: message bits (bit 3 = first) feeding each codeword column
+        unsigned char sliceCheckMask[3];   ///< Bit-sliced code: codeword columns (bit 6 = column 0) in each parity check
+        unsigned char sliceSyndrome[7];    ///< Bit-sliced code: syndrome of a single error in each column
+        int sliceDataColumn[4];            ///< Bit-sliced code: column holding each message bit
+
+        /**
+         * @brief Fills the lookup tables from the generator and parity check matrices.
+         */
+        void buildTables();
+
+        /**
+         * @brief Encodes 64 messages at once, one per bit lane.
+         * @param message The four message bit columns (column 0 = first bit).
+         * @param word Receives the seven codeword columns.
+         */
+        void encodeSliced(const std::uint64_t message[4], std::uint64_t word[7]) const;
+
+        /**
+         * @brief Corrects 64 received codewords in place, one per bit lane.
+         * @param word The seven columns, corrected in place; message bit i is then word[sliceDataColumn[i]].
+         */
+        void correctSliced(std::uint64_t word[7]) const;
+
+        /**
+         * @brief Encodes bytes into text records (14 binary digits + '\n'), skipping newlines like Encode.
+         * @param in The bytes to encode.
+         * @param length Number of input bytes.
+         * @param out Destination with room for 15 bytes per input byte.
+         * @return Number of bytes written to out.
+         */
+        std::size_t encodeToText(const char* in, std::size_t length, char* out) const;
+
+        /**
+         * @brief Decodes whole text records, skipping malformed lines like Decode.
+         * @param in Start of a record; the last line may lack its newline.
+         * @param length Number of input bytes.
+         * @param out Destination with room for one byte per line.
+         * @param stats Counters to update.
+         * @return Number of bytes written to out.
+         */
+        std::size_t decodeFromText(const char* in, std::size_t length, char* out, DecodeStats& stats) const;
+
         /**
          * @brief Pure virtual method for processing files.
          * @note This method must be overridden in derived classes.
@@ -57,29 +162,53 @@ class Hamming {
 class Decode : public Hamming {
 
     public:
+        /**
+         * @brief How much Decode prints to std::cout.
+         */
+        enum class Verbosity {
+            Quiet,   ///< Nothing; read the counters with getStats()
+            Summary, ///< One summary line at the end
+            Trace    ///< The summary plus every record and every correction (slow on large files)
+        };
+
         /**
          * @brief Constructor for Decode class.
          * @param file The name of the file to decode.
+         * @param verbosity What to print while decoding.
          */
-        Decode(std::string file);
+        Decode(std::string file, Verbosity verbosity = Verbosity::Summary);
         
         /**
          * @brief Destructor for Decode class.
          */
         ~Decode();
+
+        /**
+         * @brief Getter for the correction statistics.
+         * @return Counters of the decode.
+         */
+        const DecodeStats& getStats() const;
         
-    private:
+    protected:
+        /**
+         * @brief Constructor for derived decoders that drive processing themselves.
+         * @param file The name of the file to decode.
+         * @param process Whether to run processFile() immediately.
+         */
+        Decode(std::string file, bool process);
+
         /**
          * @brief Processes the file for decoding.
          */
         void processFile() override;
         
         /**
-         * @brief Parses a line of binary text into a vector of integers.
+         * @brief Parses a line of binary text into bits, without allocating.
          * @param line The binary string to parse.
-         * @return A vector of integers representing the binary data.
+         * @param bits Receives the first 14 binary digits as integers.
+         * @return The number of binary digits in the line (a valid record has exactly 14).
          */
-        std::vector<int> parseLineToBits(const std::string& line) const;
+        std::size_t parseLineToBits(const std::string& line, std::array<int, 14>& bits) const;
 
         /**
          * @brief Checks the parity of a 7-bit block.
@@ -105,9 +234,10 @@ class Decode : public Hamming {
         /**
          * @brief Corrects a 7-bit block by fixing errors if necessary.
          * @param block The 7-bit block to correct.
-         * @return The corrected block.
+         * @param stats Counters to update.
+         * @return The corrected block (unchanged if the error cannot be located).
          */
-        Eigen::Matrix<int, 1, 7> correctBlock(const Eigen::Matrix<int, 1, 7>& block) const;
+        Eigen::Matrix<int, 1, 7> correctBlock(const Eigen::Matrix<int, 1, 7>& block, DecodeStats& stats) const;
 
         /**
          * @brief Converts a byte (8-bit data) to a character.
@@ -126,12 +256,453 @@ class Decode : public Hamming {
 
         /**
          * @brief Parses and corrects a line of data.
-         * @param line The line to parse.
-         * @return A pair of 4-bit matrices representing the corrected data.
+         * @param line The line to parse; must hold 14 binary digits.
+         * @param stats Counters to update.
+         * @return A pair of 4-bit matrices representing the corrected data (zero if the line is malformed).
+         */
+        std::pair<Eigen::Matrix<int, 1, 4>, Eigen::Matrix<int, 1, 4>> parseAndCorrectBlock(const std::string& line, DecodeStats& stats) const;
+
+        Verbosity verbosity; ///< What to print while decoding
+        DecodeStats stats;   ///< Correction statistics
+};
+
+/**
+ * @class RangeDecode
+ * @brief Derived class for decoding a byte range of an encoded file.
+ * 
+ * Every character of the text format is one fixed-size record (14 bits plus a newline),
+ * so the records for a byte range can be read directly with pread() instead of decoding
+ * the file from the start. Packed containers are located through their trailer chunk index.
+ */
+class RangeDecode : public Decode {
+
+    public:
+        static const std::size_t recordSize = 15; ///< Bytes per text record (14 bits + '\n')
+
+        /**
+         * @brief Constructor for RangeDecode class.
+         * @param file The name of the encoded file.
+         * @param offset Index of the first decoded byte to return.
+         * @param length Number of decoded bytes to return.
+         */
+        RangeDecode(std::string file, std::size_t offset, std::size_t length);
+
+        /**
+         * @brief Destructor for RangeDecode class.
+         */
+        ~RangeDecode();
+
+        /**
+         * @brief Getter for the decoded bytes.
+         * @return The decoded range (shorter than requested if it ran past the end of the file).
+         */
+        const std::string& getDecoded() const;
+
+    private:
+        /**
+         * @brief Reads and decodes only the records covering the requested range.
+         */
+        void processFile() override;
+
+        /**
+         * @brief Decodes the range from a packed container using its chunk index.
+         * @param fd Open file descriptor of the container.
+         */
+        void processContainer(int fd);
+
+        std::size_t rangeOffset;  ///< Index of the first decoded byte
+        std::size_t rangeLength;  ///< Number of decoded bytes requested
+        std::string decoded;      ///< Decoded bytes of the range
+};
+
+/**
+ * @class OverlayDecode
+ * @brief Derived class for decoding a clean encoded file with a sparse error overlay applied on the fly.
+ * 
+ * The overlay's flips are XORed into the codewords between parsing and correction, so a fault
+ * experiment decodes the clean file under any saved error map without a corrupted copy on disk.
+ * Codewords are numbered like ErrorEncode numbers them: two per well-formed record.
+ */
+class OverlayDecode : public Decode {
+
+    public:
+        /**
+         * @brief Constructor for OverlayDecode class.
+         * @param file The name of the clean encoded text file.
+         * @param errors The overlay to apply.
+         */
+        OverlayDecode(std::string file, const ErrorMap& errors);
+
+        /**
+         * @brief Destructor for OverlayDecode class.
+         */
+        ~OverlayDecode();
+
+    private:
+        /**
+         * @brief Decodes the file with the overlay into _overlay_decoded.txt.
+         */
+        void processFile() override;
+
+        const ErrorMap& errors; ///< Overlay to apply
+};
+
+/**
+ * @class PackedEncode
+ * @brief Derived class for encoding files into the packed chunked container.
+ * 
+ * Every byte is stored as two 7-bit codewords (one per byte), grouped into chunks that are
+ * listed in a trailer index together with an optional CRC32C of their plaintext.
+ */
+class PackedEncode : public Hamming {
+
+    public:
+        static const std::uint32_t defaultChunkSize = 65536; ///< Plaintext bytes per chunk
+
+        /**
+         * @brief Constructor for PackedEncode class.
+         * @param file The name of the file to encode.
+         * @param chunkSize Plaintext bytes per chunk.
+         * @param withCrc Whether to store a CRC32C per chunk.
+         */
+        PackedEncode(std::string file, std::uint32_t chunkSize = defaultChunkSize, bool withCrc = true);
+
+        /**
+         * @brief Destructor for PackedEncode class.
+         */
+        ~PackedEncode();
+
+    private:
+        /**
+         * @brief Processes the file for encoding.
+         */
+        void processFile() override;
+
+        std::uint32_t chunkSize; ///< Plaintext bytes per chunk
+        bool withCrc;            ///< Whether chunks carry a CRC32C
+};
+
+/**
+ * @class PackedDecode
+ * @brief Derived class for decoding the packed chunked container.
+ * 
+ * Chunks whose CRC32C does not match after correction (e.g. a 2-bit error that Hamming
+ * miscorrected) are reported and listed instead of being passed off as good data.
+ */
+class PackedDecode : public Hamming {
+
+    public:
+        /**
+         * @brief Constructor for PackedDecode class.
+         * @param file The name of the container to decode.
+         */
+        PackedDecode(std::string file);
+
+        /**
+         * @brief Destructor for PackedDecode class.
+         */
+        ~PackedDecode();
+
+        /**
+         * @brief Getter for chunks that failed their CRC32C check.
+         * @return Indices of the failed chunks, so they can be re-fetched.
+         */
+        const std::vector<std::size_t>& getFailedChunks() const;
+
+        /**
+         * @brief Getter for the correction statistics.
+         * @return Counters of the decode; blocks of failed chunks count as uncorrectable.
+         */
+        const DecodeStats& getStats() const;
+
+    private:
+        /**
+         * @brief Processes the container for decoding.
+         */
+        void processFile() override;
+
+        std::vector<std::size_t> failedChunks; ///< Chunks whose CRC32C did not match
+        DecodeStats stats;                     ///< Correction statistics
+};
+
+/**
+ * @class Scrub
+ * @brief Derived class for correcting stored encoded files in place.
+ * 
+ * The file is mapped read-only and every codeword's syndrome is checked; only records that
+ * held a correctable error are rewritten with pwrite(), so clean pages are never dirtied.
+ * Works on both the text format and packed containers.
+ */
+class Scrub : public Hamming {
+
+    public:
+        static const std::size_t maxRunBytes = 64 << 10; ///< Largest run of adjacent rewritten text records written at once
+
+        /**
+         * @struct Summary
+         * @brief What a scrub pass found and fixed.
+         */
+        struct Summary {
+            std::size_t records = 0;        ///< Records (text lines or packed bytes) scanned
+            std::size_t correctedBlocks = 0; ///< Codewords with a single-bit error that were fixed
+            std::size_t rewrittenBytes = 0;  ///< Bytes written back to the file
+            std::size_t writes = 0;          ///< pwrite() calls issued
+            std::size_t malformed = 0;       ///< Non-empty text lines that were not 14 binary digits
+            std::size_t failedChunks = 0;    ///< Container chunks left untouched because their CRC32C failed
+        };
+
+        /**
+         * @brief Constructor for Scrub class.
+         * @param file The name of the encoded file to scrub.
+         */
+        Scrub(std::string file);
+
+        /**
+         * @brief Destructor for Scrub class.
+         */
+        ~Scrub();
+
+        /**
+         * @brief Getter for the scrub summary.
+         * @return What was scanned and fixed.
+         */
+        const Summary& getSummary() const;
+
+    private:
+        /**
+         * @brief Scrubs the file in place.
+         */
+        void processFile() override;
+
+        /**
+         * @brief Scrubs a text-format file.
+         * @param fd File descriptor open for writing.
+         * @param data The mapped file.
+         * @param size The file size.
+         */
+        void scrubText(int fd, const char* data, std::size_t size);
+
+        /**
+         * @brief Scrubs a packed container, chunk by chunk.
+         * @param fd File descriptor open for writing.
+         * @param data The mapped file.
+         */
+        void scrubContainer(int fd, const unsigned char* data);
+
+        /**
+         * @brief Writes a corrected run of bytes back to the file.
+         * @param fd File descriptor open for writing.
+         * @param bytes The corrected bytes.
+         * @param length Number of bytes.
+         * @param offset File offset of the run.
+         * @return False if the write failed.
+         */
+        bool writeBack(int fd, const void* bytes, std::size_t length, std::size_t offset);
+
+        Summary summary; ///< Results of the last scrub
+};
+
+/**
+ * @class ParallelEncode
+ * @brief Derived class for encoding large files on several threads.
+ * 
+ * Every input byte except a newline maps to one 15-byte text record, so after counting the
+ * newlines of each chunk its output offset is known and chunks are encoded independently and
+ * written in place with pwrite(). The output is byte-identical to Encode's _out.txt.
+ */
+class ParallelEncode : public Hamming {
+
+    public:
+        static const std::size_t defaultChunkSize = 1 << 20; ///< Input bytes per task
+
+        /**
+         * @brief Constructor for ParallelEncode class.
+         * @param file The name of the file to encode.
+         * @param threads Number of worker threads (0 = one per core).
+         * @param chunkSize Input bytes per task.
+         */
+        ParallelEncode(std::string file, unsigned threads = 0, std::size_t chunkSize = defaultChunkSize);
+
+        /**
+         * @brief Constructor for ParallelEncode class running on an existing pool.
+         * @param file The name of the file to encode.
+         * @param pool Pool to run the chunk tasks on (may be called from one of its workers).
+         * @param chunkSize Input bytes per task.
+         */
+        ParallelEncode(std::string file, ThreadPool& pool, std::size_t chunkSize = defaultChunkSize);
+
+        /**
+         * @brief Destructor for ParallelEncode class.
+         */
+        ~ParallelEncode();
+
+    private:
+        /**
+         * @brief Processes the file for encoding.
          */
-        std::pair<Eigen::Matrix<int, 1, 4>, Eigen::Matrix<int, 1, 4>> parseAndCorrectBlock(const std::string& line) const;
+        void processFile() override;
+
+        unsigned threads;       ///< Number of worker threads
+        std::size_t chunkSize;  ///< Input bytes per task
+        ThreadPool* sharedPool; ///< Pool to run on, or nullptr to start one for this file
 };
 
+/**
+ * @class ParallelDecode
+ * @brief Derived class for decoding large text-format files on several threads.
+ * 
+ * The input is split into byte ranges that each move forward to the next record boundary.
+ * Because malformed lines produce no output, each range's output offset comes from a prefix
+ * sum over the decoded lengths; the result is byte-identical to a serial Decode.
+ */
+class ParallelDecode : public Hamming {
+
+    public:
+        static const std::size_t defaultChunkSize = 4 << 20; ///< Input bytes per task
+
+        /**
+         * @brief Constructor for ParallelDecode class.
+         * @param file The name of the file to decode.
+         * @param threads Number of worker threads (0 = one per core).
+         * @param chunkSize Input bytes per task.
+         */
+        ParallelDecode(std::string file, unsigned threads = 0, std::size_t chunkSize = defaultChunkSize);
+
+        /**
+         * @brief Constructor for ParallelDecode class running on an existing pool.
+         * @param file The name of the file to decode.
+         * @param pool Pool to run the chunk tasks on (may be called from one of its workers).
+         * @param chunkSize Input bytes per task.
+         */
+        ParallelDecode(std::string file, ThreadPool& pool, std::size_t chunkSize = defaultChunkSize);
+
+        /**
+         * @brief Destructor for ParallelDecode class.
+         */
+        ~ParallelDecode();
+
+        /**
+         * @brief Getter for the merged correction statistics.
+         * @return Counters summed over all threads.
+         */
+        const DecodeStats& getStats() const;
+
+    private:
+        /**
+         * @brief Processes the file for decoding.
+         */
+        void processFile() override;
+
+        unsigned threads;       ///< Number of worker threads
+        std::size_t chunkSize;  ///< Input bytes per task
+        ThreadPool* sharedPool; ///< Pool to run on, or nullptr to start one for this file
+        DecodeStats stats;     ///< Merged correction statistics
+};
+
+/**
+ * @class Pipeline
+ * @brief Derived class for streaming a file through reader, codec and writer threads.
+ * 
+ * Chunk i goes to lane i % codecThreads. Each lane owns preallocated chunk buffers and three
+ * lock-free SPSC rings (free, filled, done), so the writer restores order by visiting the lanes
+ * round-robin and nothing is allocated or locked per chunk. When the writer falls behind, the
+ * free rings run dry and the reader blocks; a stage with nothing to do sleeps instead of spinning.
+ * Small inputs get only as many lanes and slots as they have chunks.
+ */
+class Pipeline : public Hamming {
+
+    public:
+        /**
+         * @brief Direction of the pipeline.
+         */
+        enum class Mode { Encode, Decode };
+
+        static const std::size_t defaultChunkSize = 64 << 10;  ///< Input bytes per chunk
+        static const std::size_t defaultSlots = 4;             ///< Chunk buffers per lane (at most)
+
+        /**
+         * @brief Constructor for Pipeline class.
+         * @param file The name of the file to process.
+         * @param mode Encode plain text to _out.txt or decode text records to _decoded.txt.
+         * @param codecThreads Number of codec threads (0 = one per core; capped at the input's chunk count).
+         * @param chunkSize Input bytes per chunk.
+         */
+        Pipeline(std::string file, Mode mode, unsigned codecThreads = 0, std::size_t chunkSize = defaultChunkSize);
+
+        /**
+         * @brief Destructor for Pipeline class.
+         */
+        ~Pipeline();
+
+        /**
+         * @brief Getter for the correction statistics of a decode.
+         * @return Counters summed over all codec threads.
+         */
+        const DecodeStats& getStats() const;
+
+    private:
+        /**
+         * @brief Runs the three stages until the input is exhausted.
+         */
+        void processFile() override;
+
+        Mode mode;                 ///< Encode or decode
+        unsigned codecThreads;     ///< Number of codec threads (lanes)
+        std::size_t chunkSize;     ///< Input bytes per chunk
+        DecodeStats stats;         ///< Merged correction statistics
+};
+
+/**
+ * @class Batch
+ * @brief Derived class for processing a list of files on one work-stealing pool.
+ * 
+ * The manifest lists one file per line, optionally prefixed by an operation
+ * (encode, decode, pack, unpack or scrub). Every file becomes a task; encode and decode split
+ * large files further into chunk tasks on the same pool, so small files never wait behind
+ * large ones and idle workers steal whatever is left.
+ */
+class Batch : public Hamming {
+
+    public:
+        /**
+         * @brief Constructor for Batch class.
+         * @param manifest The name of the file listing the inputs.
+         * @param defaultOperation Operation for lines that only name a file.
+         * @param threads Number of worker threads (0 = one per core).
+         */
+        Batch(std::string manifest, std::string defaultOperation = "encode", unsigned threads = 0);
+
+        /**
+         * @brief Destructor for Batch class.
+         */
+        ~Batch();
+
+        /**
+         * @brief Getter for the number of entries that could not be processed.
+         * @return Entries with a missing file or an unknown operation.
+         */
+        std::size_t getFailures() const;
+
+    private:
+        /**
+         * @brief Reads the manifest and runs every entry.
+         */
+        void processFile() override;
+
+        std::string defaultOperation; ///< Operation for lines without one
+        unsigned threads;             ///< Number of worker threads
+        std::size_t failures;         ///< Entries that could not be processed
+};
+
+/**
+ * @brief Decodes a byte range of an encoded file without scanning it from the start.
+ * @param path The name of the encoded file.
+ * @param offset Index of the first decoded byte.
+ * @param length Number of decoded bytes.
+ * @return The decoded bytes.
+ */
+std::string decodeRange(const std::string& path, std::size_t offset, std::size_t length);
+
 /**
  * @class Encode
  * @brief Derived class for encoding Hamming codes.
@@ -166,6 +737,13 @@ class Encode : public Hamming {
         void printEncodedMsg(const Eigen::Matrix<int, 1, 7>& encodedMessage) const;
 
     protected:
+        /**
+         * @brief Constructor for derived encoders that drive processing themselves.
+         * @param file The name of the file to encode.
+         * @param process Whether to run processFile() immediately.
+         */
+        Encode(std::string file, bool process);
+
         /**
          * @brief Processes the file for encoding.
          */
@@ -198,6 +776,8 @@ class Encode : public Hamming {
          */
         std::vector<Eigen::Matrix<int, 1, 7>>& getEncodedMessages();
 
+        friend class ErrorEncode;  ///< Streams another encoder's codewords through a channel
+
     private:
         std::vector<Eigen::Matrix<int, 1, 7>> encodedMessages;  ///< Stores the encoded Hamming blocks
 };
@@ -206,16 +786,56 @@ class Encode : public Hamming {
  * @class ErrorEncode
  * @brief Derived class for encoding Hamming codes with introduced errors.
  * 
- * This class encodes messages and introduces random errors in the encoded blocks.
+ * This class passes clean codewords through a channel model (see HammingChannel.h) or a saved
+ * error overlay (see HammingErrorMap.h) and writes the result to _e_out.txt in one streaming pass. The clean codewords come from a plain file (encoded
+ * with the lookup tables), from an existing encoded file, or from an Encode object that has
+ * already run, so nothing is encoded twice or copied. The default channel flips one bit per
+ * block; the flipped bit of block i is a pure function of (seed, i), so runs are reproducible.
  */
 class ErrorEncode : public Encode {
 
     public:
+        /**
+         * @brief What the input file holds.
+         */
+        enum class Input { Plain, Encoded };
+
+        static const std::uint64_t defaultSeed = 0x5EED; ///< Seed used when none is given
+
         /**
          * @brief Constructor for ErrorEncode class.
-         * @param file The name of the file to encode.
+         * @param file The name of the file to read.
+         * @param seed Seed of the error pattern.
+         * @param channel Channel specification, e.g. "exact:1", "bsc:1e-3" or "ge:1e-4,0.1,0,0.5".
+         * @param input Whether the file is plain text or already encoded (text records, e.g. _out.txt).
+         */
+        ErrorEncode(std::string file, std::uint64_t seed = defaultSeed, std::string channel = "exact:1", Input input = Input::Plain);
+
+        /**
+         * @brief Constructor for ErrorEncode class that reuses the codewords of an encoder that has run.
+         * @param clean The encoder; its codewords are read, not modified.
+         * @param seed Seed of the error pattern.
+         * @param channel Channel specification.
+         */
+        ErrorEncode(const Encode& clean, std::uint64_t seed = defaultSeed, std::string channel = "exact:1");
+
+        /**
+         * @brief Constructor for ErrorEncode class that replays a saved error map instead of a channel.
+         * @param file The name of the file to read.
+         * @param errors The overlay to apply.
+         * @param input Whether the file is plain text or already encoded.
+         */
+        ErrorEncode(std::string file, const ErrorMap& errors, Input input = Input::Plain);
+
+        /**
+         * @brief Constructor for ErrorEncode class that replays a recorded fault map onto stored data.
+         *
+         * The encoded file (text records or a packed container) is copied to _e_out.txt or _e.hmc in
+         * large blocks while the sorted faults are merged in, so the pass runs at I/O speed.
+         * @param file The name of the encoded file.
+         * @param faults The fault map, consumed in order.
          */
-        ErrorEncode(std::string file);
+        ErrorEncode(std::string file, FaultMapReader& faults);
         
         /**
          * @brief Destructor for ErrorEncode class.
@@ -223,17 +843,95 @@ class ErrorEncode : public Encode {
         ~ErrorEncode();
 
         /**
-         * @brief Encodes the file and introduces errors.
+         * @brief Streams the clean codewords through the channel into _e_out.txt.
          */
         void encodeFile();
 
         /**
-         * @brief Introduces a random error in each Hamming code block.
+         * @brief Checks whether a fault replay could not open, read or write its files.
+         * @return True if the replay stopped early and its output is incomplete or missing.
          */
-        void errorEncodeRand();
+        bool replayFailed() const;
 
     private:
-        std::vector<Eigen::Matrix<int, 1, 7>> hammingCodeWithErrors;  ///< Stores Hamming blocks with errors
+        /**
+         * @brief Processes the input through the channel, the overlay or the fault map.
+         */
+        void processFile() override;
+
+        /**
+         * @brief Copies the encoded file while flipping the bits listed in the fault map.
+         */
+        void replayFaults();
+
+        std::uint64_t seed;     ///< Seed of the error pattern
+        std::string channel;    ///< Channel specification
+        Input input;            ///< What fileName holds
+        const Encode* clean;    ///< Encoder whose codewords are the input, or nullptr to read fileName
+        const ErrorMap* errors; ///< Overlay to replay, or nullptr to use the channel
+        FaultMapReader* faults; ///< Fault map to replay onto stored data, or nullptr
+        bool ioFailed = false;  ///< The fault replay hit a file error
+};
+
+/**
+ * @class RoundTrip
+ * @brief Derived class for a fused encode, channel, decode and compare pass over a file.
+ * 
+ * Each chunk is encoded into packed codewords, passed through a channel model, corrected and
+ * compared with the original bytes while it is still in cache; nothing is written to disk and no
+ * text is formatted or parsed. Every byte, including newlines, makes the round trip.
+ */
+class RoundTrip : public Hamming {
+
+    public:
+        static const std::size_t defaultChunkSize = 16 << 10; ///< Input bytes per chunk (codewords stay in L1/L2)
+
+        /**
+         * @struct Summary
+         * @brief What the round trip measured.
+         */
+        struct Summary {
+            std::size_t bytes = 0;          ///< Input bytes
+            std::size_t blocks = 0;         ///< Codewords sent through the channel
+            std::size_t flipped = 0;        ///< Bits flipped by the channel
+            std::size_t corrected = 0;      ///< Codewords with a non-zero syndrome
+            std::size_t byteErrors = 0;     ///< Decoded bytes that differ from the input
+            std::size_t bitErrors = 0;      ///< Decoded bits that differ from the input
+            std::size_t blockErrors = 0;    ///< Decoded 4-bit messages that differ from the input
+            double seconds = 0;             ///< Wall time of the pass
+            bool failed = false;            ///< The channel or the file could not be opened or read
+        };
+
+        /**
+         * @brief Constructor for RoundTrip class.
+         * @param file The name of the file to round-trip.
+         * @param channel Channel specification (see Channel::create).
+         * @param seed Seed of the error pattern.
+         * @param chunkSize Input bytes per chunk.
+         */
+        RoundTrip(std::string file, std::string channel = "exact:1", std::uint64_t seed = ErrorEncode::defaultSeed, std::size_t chunkSize = defaultChunkSize);
+
+        /**
+         * @brief Destructor for RoundTrip class.
+         */
+        ~RoundTrip();
+
+        /**
+         * @brief Getter for the round trip summary.
+         * @return Counters and timing of the pass.
+         */
+        const Summary& getSummary() const;
+
+    private:
+        /**
+         * @brief Runs the fused pass and prints the summary.
+         */
+        void processFile() override;
+
+        std::string channel;   ///< Channel specification
+        std::uint64_t seed;    ///< Seed of the error pattern
+        std::size_t chunkSize; ///< Input bytes per chunk
+        Summary summary;       ///< Results of the pass
 };
 
 #endif
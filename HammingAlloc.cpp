@@ -0,0 +1,96 @@
+// Allocation counting (see HammingAlloc.h)
+// With HAMMING_ALLOC_TRACK the global operator new/delete are replaced: every call bumps a relaxed
+// atomic and forwards to malloc/free (aligned_alloc for over-aligned types). The array, nothrow
+// and sized forms forward to these, so every heap call of the program is counted exactly once
+
+#include <iomanip>
+#include <atomic>
+#include <cstddef>
+#include <cstdlib>
+#include <new>
+#include "HammingAlloc.h"
+
+#ifdef HAMMING_ALLOC_TRACK
+
+namespace {
+    std::atomic<std::uint64_t> allocations{0};
+    std::atomic<std::uint64_t> allocatedBytes{0};
+    std::atomic<std::uint64_t> frees{0};
+
+    void* allocate(std::size_t size, std::size_t alignment) {
+        allocations.fetch_add(1, std::memory_order_relaxed);
+        allocatedBytes.fetch_add(size, std::memory_order_relaxed);
+        if (size == 0) size = 1;
+        void* pointer = alignment > alignof(std::max_align_t)
+                      ? std::aligned_alloc(alignment, (size + alignment - 1) / alignment * alignment)
+                      : std::malloc(size);
+        return pointer;
+    }
+
+    void release(void* pointer) {
+        if (!pointer) return;
+        frees.fetch_add(1, std::memory_order_relaxed);
+        std::free(pointer);
+    }
+}
+
+AllocCounts AllocTracker::counts() {
+    AllocCounts counts;
+    counts.allocations = allocations.load(std::memory_order_relaxed);
+    counts.bytes = allocatedBytes.load(std::memory_order_relaxed);
+    counts.frees = frees.load(std::memory_order_relaxed);
+    return counts;
+}
+
+
+void* operator new(std::size_t size) {
+    void* pointer = allocate(size, 0);
+    if (!pointer) throw std::bad_alloc();
+    return pointer;
+}
+
+void* operator new[](std::size_t size) {
+    return operator new(size);
+}
+
+void* operator new(std::size_t size, std::align_val_t alignment) {
+    void* pointer = allocate(size, static_cast<std::size_t>(alignment));
+    if (!pointer) throw std::bad_alloc();
+    return pointer;
+}
+
+void* operator new[](std::size_t size, std::align_val_t alignment) {
+    return operator new(size, alignment);
+}
+
+void* operator new(std::size_t size, const std::nothrow_t&) noexcept {
+    return allocate(size, 0);
+}
+
+void* operator new[](std::size_t size, const std::nothrow_t&) noexcept {
+    return allocate(size, 0);
+}
+
+void operator delete(void* pointer) noexcept { release(pointer); }
+void operator delete[](void* pointer) noexcept { release(pointer); }
+void operator delete(void* pointer, std::size_t) noexcept { release(pointer); }
+void operator delete[](void* pointer, std::size_t) noexcept { release(pointer); }
+void operator delete(void* pointer, std::align_val_t) noexcept { release(pointer); }
+void operator delete[](void* pointer, std::align_val_t) noexcept { release(pointer); }
+void operator delete(void* pointer, std::size_t, std::align_val_t) noexcept { release(pointer); }
+void operator delete[](void* pointer, std::size_t, std::align_val_t) noexcept { release(pointer); }
+void operator delete(void* pointer, const std::nothrow_t&) noexcept { release(pointer); }
+void operator delete[](void* pointer, const std::nothrow_t&) noexcept { release(pointer); }
+
+#endif
+
+
+void AllocTracker::report(std::ostream& out, std::uint64_t bytesProcessed) {
+    AllocCounts totals = counts();
+    out << "Allocations: " << totals.allocations << " (" << totals.bytes << " bytes), " << totals.frees << " frees";
+    if (bytesProcessed) {
+        out << ", " << std::fixed << std::setprecision(2) << totals.allocations / (bytesProcessed / 1e6) << " per MB of "
+            << bytesProcessed << " bytes processed" << std::defaultfloat;
+    }
+    out << ".\n";
+}
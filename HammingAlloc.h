@@ -0,0 +1,62 @@
+/* Colton Criswell and Zach Hamby
+ * Final Project - CS-300
+ */
+
+#ifndef HAMMING_ALLOC_H
+#define HAMMING_ALLOC_H
+
+#include <cstdint>
+#include <ostream>
+
+/*
+ * Heap allocation counting for debug and benchmark builds, compiled in with -DHAMMING_ALLOC_TRACK
+ * (make clean && make ALLOC_TRACK=1; the bench build always has it).
+ *
+ * HammingAlloc.cpp then replaces the global operator new and delete with versions that count
+ * every call before forwarding to malloc and free. The bench uses the counts to fail any
+ * in-memory encode or decode kernel that allocates once warmed up; main reports the totals at
+ * exit per MB of codec input. Without the flag, counts() is always zero and nothing is replaced.
+ */
+
+/**
+ * @struct AllocCounts
+ * @brief Heap calls since the process started.
+ */
+struct AllocCounts {
+    std::uint64_t allocations = 0; ///< operator new calls
+    std::uint64_t bytes = 0;       ///< Bytes requested by them
+    std::uint64_t frees = 0;       ///< operator delete calls on non-null pointers
+};
+
+/**
+ * @class AllocTracker
+ * @brief Access to the counting operator new/delete.
+ */
+class AllocTracker {
+
+    public:
+#ifdef HAMMING_ALLOC_TRACK
+        static constexpr bool tracking = true; ///< Whether the counting hooks are compiled in
+
+        /**
+         * @brief Reads the counters.
+         * @return Counts over all threads.
+         */
+        static AllocCounts counts();
+#else
+        static constexpr bool tracking = false;
+
+        static AllocCounts counts() {
+            return AllocCounts();
+        }
+#endif
+
+        /**
+         * @brief Prints the counters and the allocations per MB of processed input.
+         * @param out Destination stream.
+         * @param bytesProcessed Input bytes processed so far (0 omits the rate).
+         */
+        static void report(std::ostream& out, std::uint64_t bytesProcessed);
+};
+
+#endif
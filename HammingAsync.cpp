@@ -0,0 +1,221 @@
+// Coroutine-based codec API
+// Scheduler is a single-threaded poll() loop; every read and write is a suspension point,
+// so one thread interleaves many encode/decode streams
+// AsyncCodec reuses the table-driven text encoder/decoder shared with the other modes
+
+#include <iostream>
+#include <string>
+#include <vector>
+#include <cerrno>
+#include <cstring>
+#include <fcntl.h>
+#include <poll.h>
+#include <unistd.h>
+#include "HammingAsync.h"
+#include "HammingLatency.h"
+
+
+long Scheduler::IoAwaitable::await_resume() const {
+    if (result < 0) errno = error;
+    return result;
+}
+
+bool Scheduler::IoAwaitable::attempt() {
+    LatencyScope latency(events == POLLIN ? LatencyOp::Read : LatencyOp::Write);
+    for (;;) {
+        ssize_t n = events == POLLIN ? ::read(fd, buffer, length) : ::write(fd, buffer, length);
+        if (n < 0 && errno == EINTR) continue;
+        if (n < 0 && (errno == EAGAIN || errno == EWOULDBLOCK)) return false;
+        result = static_cast<long>(n);
+        error = n < 0 ? errno : 0;
+        return true;
+    }
+}
+
+void Scheduler::spawn(Task<void> task) {
+    ready.push_back(task.getHandle());
+    tasks.push_back(std::move(task));
+}
+
+void Scheduler::run() {
+    std::vector<pollfd> fds;
+    while (!tasks.empty()) {
+        //Resume everything that is runnable; each coroutine runs until its next I/O
+        while (!ready.empty()) {
+            std::coroutine_handle<> handle = ready.front();
+            ready.pop_front();
+            handle.resume();
+        }
+        tasks.remove_if([](const Task<void>& task) { return task.getHandle().done(); });
+        if (waiters.empty()) continue;
+
+        //Make the transfers whose descriptors are ready and wake their coroutines, in the order they
+        //parked; a transfer that would still block stays parked
+        fds.clear();
+        for (const Waiter& waiter : waiters) fds.push_back(pollfd{waiter.io->fd, waiter.io->events, 0});
+        if (poll(fds.data(), fds.size(), -1) < 0 && errno != EINTR) {
+            std::cerr << "Error: poll() failed in the coroutine scheduler." << std::endl;
+            return;
+        }
+
+        std::size_t kept = 0;
+        for (std::size_t i = 0; i < waiters.size(); ++i) {
+            if (fds[i].revents != 0 && waiters[i].io->attempt()) ready.push_back(waiters[i].handle);
+            else waiters[kept++] = waiters[i];
+        }
+        waiters.resize(kept);
+    }
+}
+
+Scheduler::IoAwaitable Scheduler::read(int fd, void* buffer, std::size_t length) {
+    return IoAwaitable{*this, fd, POLLIN, buffer, length};
+}
+
+Scheduler::IoAwaitable Scheduler::write(int fd, const void* buffer, std::size_t length) {
+    return IoAwaitable{*this, fd, POLLOUT, const_cast<void*>(buffer), length};
+}
+
+void Scheduler::waitFor(IoAwaitable& io, std::coroutine_handle<> handle) {
+    waiters.push_back(Waiter{&io, handle});
+}
+
+
+//AsyncCodec class constructor
+AsyncCodec::AsyncCodec(Scheduler& scheduler) : Hamming("<async>"), scheduler(scheduler) {}
+AsyncCodec::~AsyncCodec() {}
+
+void AsyncCodec::processFile() {}
+
+
+Task<AsyncCodec::EncodeResult> AsyncCodec::encode(int inFd, int outFd) {
+    std::vector<char> in(defaultChunkSize);
+    std::vector<char> out(defaultChunkSize * 15);
+    EncodeResult result;
+
+    for (;;) {
+        long n = co_await scheduler.read(inFd, in.data(), in.size());
+        if (n <= 0) {
+            if (n < 0) {
+                std::cerr << "Error reading input: " << std::strerror(errno) << std::endl;
+                result.failed = true;
+            }
+            break;
+        }
+        std::size_t length = encodeToText(in.data(), static_cast<std::size_t>(n), out.data());
+        if (!co_await writeAll(outFd, out.data(), length)) {
+            result.failed = true;
+            break;
+        }
+        result.written += length;
+    }
+    co_return result;
+}
+
+Task<AsyncCodec::DecodeResult> AsyncCodec::decode(int inFd, int outFd) {
+    std::vector<char> in(defaultChunkSize + 64);
+    std::vector<char> out(in.size() / 14 + 1);
+    DecodeResult result;
+    DecodeStats& stats = result.stats;
+    std::size_t carry = 0;  //Bytes of an unfinished line kept at the front of in
+
+    for (;;) {
+        if (in.size() - carry < defaultChunkSize) in.resize(carry + defaultChunkSize);
+        long n = co_await scheduler.read(inFd, in.data() + carry, in.size() - carry);
+        if (n < 0) {
+            std::cerr << "Error reading input: " << std::strerror(errno) << std::endl;
+            result.failed = true;
+            break;
+        }
+        std::size_t length = carry + static_cast<std::size_t>(n);
+
+        //Decode complete lines only, unless the input has ended
+        std::size_t complete = length;
+        if (n > 0) {
+            while (complete > 0 && in[complete - 1] != '\n') --complete;
+        }
+
+        if (out.size() < complete / 14 + 1) out.resize(complete / 14 + 1);
+        std::size_t decoded = decodeFromText(in.data(), complete, out.data(), stats);
+        if (!co_await writeAll(outFd, out.data(), decoded)) {
+            result.failed = true;
+            break;
+        }
+
+        carry = length - complete;
+        std::memmove(in.data(), in.data() + complete, carry);
+        if (n == 0) break;
+    }
+    co_return result;
+}
+
+Task<void> AsyncCodec::encodeFile(std::string file) {
+    std::string outFileName = file.substr(0, file.find_last_of('.')) + "_out.txt";
+    int inFd = open(file.c_str(), O_RDONLY | O_NONBLOCK);
+    int outFd = inFd < 0 ? -1 : open(outFileName.c_str(), O_WRONLY | O_CREAT | O_TRUNC | O_NONBLOCK, 0644);
+    if (inFd < 0 || outFd < 0) {
+        std::cerr << "Error opening file: " << (inFd < 0 ? file : outFileName) << std::endl;
+        if (inFd >= 0) close(inFd);
+        ++failures;
+        co_return;
+    }
+
+    EncodeResult result = co_await encode(inFd, outFd);
+    close(inFd);
+    close(outFd);
+    if (result.failed) {
+        std::cerr << "Encoding failed after " << result.written << " bytes; " << outFileName << " is incomplete." << std::endl;
+        ++failures;
+        co_return;
+    }
+    std::cout << "Encoding complete. " << result.written << " bytes written to " + outFileName + ".\n";
+}
+
+Task<void> AsyncCodec::decodeFile(std::string file) {
+    std::string outFileName = file.substr(0, file.find_last_of('.')) + "_decoded.txt";
+    int inFd = open(file.c_str(), O_RDONLY | O_NONBLOCK);
+    int outFd = inFd < 0 ? -1 : open(outFileName.c_str(), O_WRONLY | O_CREAT | O_TRUNC | O_NONBLOCK, 0644);
+    if (inFd < 0 || outFd < 0) {
+        std::cerr << "Error opening file: " << (inFd < 0 ? file : outFileName) << std::endl;
+        if (inFd >= 0) close(inFd);
+        ++failures;
+        co_return;
+    }
+
+    DecodeResult result = co_await decode(inFd, outFd);
+    close(inFd);
+    close(outFd);
+    if (result.failed) {
+        std::cerr << "Decoding failed; " << outFileName << " is incomplete." << std::endl;
+        ++failures;
+        co_return;
+    }
+    std::cout << "Decoding complete. ";
+    result.stats.print(std::cout);
+    std::cout << " Output written to " + outFileName + ".\n";
+}
+
+Generator<std::span<const std::byte>> AsyncCodec::encodedChunks(std::function<std::span<const std::byte>()> source) {
+    std::vector<char> out;
+    for (std::span<const std::byte> chunk = source(); !chunk.empty(); chunk = source()) {
+        if (out.size() < chunk.size() * 15) out.resize(chunk.size() * 15);
+        std::size_t length = encodeToText(reinterpret_cast<const char*>(chunk.data()), chunk.size(), out.data());
+        co_yield std::span<const std::byte>(reinterpret_cast<const std::byte*>(out.data()), length);
+    }
+}
+
+std::size_t AsyncCodec::getFailures() const {
+    return failures;
+}
+
+Task<bool> AsyncCodec::writeAll(int fd, const char* data, std::size_t length) {
+    std::size_t done = 0;
+    while (done < length) {
+        long n = co_await scheduler.write(fd, data + done, length - done);
+        if (n <= 0) {
+            std::cerr << "Error writing output: " << std::strerror(errno) << std::endl;
+            co_return false;
+        }
+        done += static_cast<std::size_t>(n);
+    }
+    co_return true;
+}
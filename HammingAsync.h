@@ -0,0 +1,380 @@
+/* Colton Criswell and Zach Hamby
+ * Final Project - CS-300
+ */
+
+#ifndef HAMMING_ASYNC_H
+#define HAMMING_ASYNC_H
+
+#include <coroutine>
+#include <cstddef>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <list>
+#include <span>
+#include <utility>
+#include <vector>
+#include "Hamming.h"
+
+/**
+ * @class Generator
+ * @brief Lazily evaluated sequence produced by a coroutine with co_yield.
+ */
+template <typename T>
+class Generator {
+
+    public:
+        /**
+         * @struct promise_type
+         * @brief Coroutine promise holding the current value.
+         */
+        struct promise_type {
+            const T* current = nullptr; ///< Value passed to the last co_yield
+
+            Generator get_return_object() { return Generator(std::coroutine_handle<promise_type>::from_promise(*this)); }
+            std::suspend_always initial_suspend() noexcept { return {}; }
+            std::suspend_always final_suspend() noexcept { return {}; }
+            std::suspend_always yield_value(const T& value) noexcept {
+                current = &value;
+                return {};
+            }
+            void return_void() noexcept {}
+            void unhandled_exception() { std::terminate(); }
+        };
+
+        /**
+         * @class iterator
+         * @brief Input iterator that resumes the coroutine on every increment.
+         */
+        class iterator {
+            public:
+                explicit iterator(std::coroutine_handle<promise_type> handle) : handle(handle) {}
+                const T& operator*() const { return *handle.promise().current; }
+                iterator& operator++() {
+                    handle.resume();
+                    return *this;
+                }
+                bool operator==(std::default_sentinel_t) const { return !handle || handle.done(); }
+
+            private:
+                std::coroutine_handle<promise_type> handle; ///< The generator coroutine
+        };
+
+        Generator(Generator&& other) noexcept : handle(std::exchange(other.handle, {})) {}
+        Generator(const Generator&) = delete;
+        ~Generator() {
+            if (handle) handle.destroy();
+        }
+
+        /**
+         * @brief Runs the coroutine up to its first co_yield.
+         * @return Iterator at the first value.
+         */
+        iterator begin() {
+            handle.resume();
+            return iterator(handle);
+        }
+
+        /**
+         * @brief End of the sequence.
+         * @return Sentinel compared against by the iterator.
+         */
+        std::default_sentinel_t end() { return {}; }
+
+    private:
+        explicit Generator(std::coroutine_handle<promise_type> handle) : handle(handle) {}
+
+        std::coroutine_handle<promise_type> handle; ///< The generator coroutine
+};
+
+/**
+ * @class Task
+ * @brief Lazily started coroutine whose result is obtained with co_await.
+ */
+template <typename T = void>
+class Task;
+
+namespace detail {
+    /**
+     * @struct TaskPromiseBase
+     * @brief Promise parts shared by Task<T> and Task<void>: resume the awaiter when finished.
+     */
+    struct TaskPromiseBase {
+        std::coroutine_handle<> continuation = std::noop_coroutine(); ///< Coroutine awaiting this task
+
+        struct FinalAwaiter {
+            bool await_ready() noexcept { return false; }
+            template <typename P>
+            std::coroutine_handle<> await_suspend(std::coroutine_handle<P> handle) noexcept {
+                return handle.promise().continuation;
+            }
+            void await_resume() noexcept {}
+        };
+
+        std::suspend_always initial_suspend() noexcept { return {}; }
+        FinalAwaiter final_suspend() noexcept { return {}; }
+        void unhandled_exception() { std::terminate(); }
+    };
+
+    template <typename T>
+    struct TaskPromise : TaskPromiseBase {
+        T value{}; ///< Result of co_return
+
+        Task<T> get_return_object();
+        void return_value(T result) { value = std::move(result); }
+        T result() { return std::move(value); }
+    };
+
+    template <>
+    struct TaskPromise<void> : TaskPromiseBase {
+        Task<void> get_return_object();
+        void return_void() noexcept {}
+        void result() {}
+    };
+}
+
+template <typename T>
+class Task {
+
+    public:
+        using promise_type = detail::TaskPromise<T>;
+
+        Task(Task&& other) noexcept : handle(std::exchange(other.handle, {})) {}
+        Task(const Task&) = delete;
+        ~Task() {
+            if (handle) handle.destroy();
+        }
+
+        bool await_ready() const noexcept { return false; }
+
+        /**
+         * @brief Starts the task and resumes the awaiting coroutine when it finishes.
+         * @param awaiting The coroutine that awaits this task.
+         * @return The task, so it runs right away on the same thread.
+         */
+        std::coroutine_handle<> await_suspend(std::coroutine_handle<> awaiting) noexcept {
+            handle.promise().continuation = awaiting;
+            return handle;
+        }
+
+        T await_resume() { return handle.promise().result(); }
+
+        /**
+         * @brief Getter for the coroutine handle.
+         * @return The handle (used by Scheduler to start top-level tasks).
+         */
+        std::coroutine_handle<promise_type> getHandle() const { return handle; }
+
+    private:
+        friend struct detail::TaskPromise<T>;
+        explicit Task(std::coroutine_handle<promise_type> handle) : handle(handle) {}
+
+        std::coroutine_handle<promise_type> handle; ///< The task coroutine
+};
+
+namespace detail {
+    template <typename T>
+    Task<T> TaskPromise<T>::get_return_object() {
+        return Task<T>(std::coroutine_handle<TaskPromise<T>>::from_promise(*this));
+    }
+    inline Task<void> TaskPromise<void>::get_return_object() {
+        return Task<void>(std::coroutine_handle<TaskPromise<void>>::from_promise(*this));
+    }
+}
+
+/**
+ * @class Scheduler
+ * @brief Single-threaded event loop that multiplexes coroutines at their I/O boundaries.
+ *
+ * Every read and write suspends the calling coroutine until poll() reports its descriptor
+ * ready and the transfer has been made, so one thread can drive many streams; regular files are
+ * always ready and simply take turns with the other streams. A readiness that turns out to be
+ * spurious (EAGAIN) parks the coroutine again instead of resuming it.
+ */
+class Scheduler {
+
+    public:
+        /**
+         * @struct IoAwaitable
+         * @brief Suspends until a descriptor is ready and one read or write on it has completed.
+         */
+        struct IoAwaitable {
+            Scheduler& scheduler; ///< Loop to wait on
+            int fd;               ///< Descriptor
+            short events;         ///< POLLIN or POLLOUT
+            void* buffer;         ///< Data to read into or write from
+            std::size_t length;   ///< Bytes requested
+            long result = 0;      ///< Outcome of the transfer
+            int error = 0;        ///< errno of a failed transfer
+
+            bool await_ready() const noexcept { return false; }
+            void await_suspend(std::coroutine_handle<> handle) { scheduler.waitFor(*this, handle); }
+
+            /**
+             * @brief Hands over the outcome of the transfer (errno is restored on error).
+             * @return Bytes transferred, 0 at end of file, -1 on error.
+             */
+            long await_resume() const;
+
+            /**
+             * @brief Tries the transfer once the descriptor is reported ready.
+             * @return False if it would still block, so the coroutine must wait again.
+             */
+            bool attempt();
+        };
+
+        /**
+         * @brief Starts a top-level task; the scheduler keeps it alive until it finishes.
+         * @param task The task to run.
+         */
+        void spawn(Task<void> task);
+
+        /**
+         * @brief Runs until every spawned task has finished.
+         */
+        void run();
+
+        /**
+         * @brief Awaitable read of up to length bytes.
+         * @param fd Descriptor to read.
+         * @param buffer Destination.
+         * @param length Bytes requested.
+         * @return Awaitable yielding the byte count.
+         */
+        IoAwaitable read(int fd, void* buffer, std::size_t length);
+
+        /**
+         * @brief Awaitable write of up to length bytes.
+         * @param fd Descriptor to write.
+         * @param buffer Source.
+         * @param length Bytes to write.
+         * @return Awaitable yielding the byte count.
+         */
+        IoAwaitable write(int fd, const void* buffer, std::size_t length);
+
+    private:
+        /**
+         * @struct Waiter
+         * @brief A coroutine parked on a descriptor.
+         */
+        struct Waiter {
+            IoAwaitable* io;                 ///< Pending transfer, in the parked coroutine's frame
+            std::coroutine_handle<> handle;  ///< Coroutine to resume
+        };
+
+        /**
+         * @brief Parks a coroutine until its transfer has been made.
+         * @param io The transfer.
+         * @param handle Coroutine to resume.
+         */
+        void waitFor(IoAwaitable& io, std::coroutine_handle<> handle);
+
+        std::vector<Waiter> waiters;              ///< Coroutines parked on I/O
+        std::deque<std::coroutine_handle<>> ready; ///< Coroutines ready to resume
+        std::list<Task<void>> tasks;              ///< Spawned top-level tasks
+};
+
+/**
+ * @class AsyncCodec
+ * @brief Coroutine front end to the Hamming codec.
+ *
+ * encode()/decode() are co_await-able and suspend only at I/O boundaries, and encodedChunks()
+ * yields encoded text records chunk by chunk without reading ahead of the consumer.
+ */
+class AsyncCodec : public Hamming {
+
+    public:
+        static const std::size_t defaultChunkSize = 64 << 10; ///< Input bytes per read
+
+        /**
+         * @struct EncodeResult
+         * @brief Outcome of encode().
+         */
+        struct EncodeResult {
+            std::size_t written = 0; ///< Bytes written
+            bool failed = false;     ///< A read or write failed, so the output is incomplete
+        };
+
+        /**
+         * @struct DecodeResult
+         * @brief Outcome of decode().
+         */
+        struct DecodeResult {
+            DecodeStats stats;       ///< Correction statistics
+            bool failed = false;     ///< A read or write failed, so the output is incomplete
+        };
+
+        /**
+         * @brief Constructor for AsyncCodec class.
+         * @param scheduler The event loop the codec's I/O runs on.
+         */
+        AsyncCodec(Scheduler& scheduler);
+
+        /**
+         * @brief Destructor for AsyncCodec class.
+         */
+        ~AsyncCodec();
+
+        /**
+         * @brief Encodes everything read from one descriptor into text records on another.
+         * @param inFd Plain text input.
+         * @param outFd Encoded output.
+         * @return Task yielding the bytes written and whether the stream failed.
+         */
+        Task<EncodeResult> encode(int inFd, int outFd);
+
+        /**
+         * @brief Decodes text records from one descriptor onto another.
+         * @param inFd Encoded input.
+         * @param outFd Decoded output.
+         * @return Task yielding the correction statistics and whether the stream failed.
+         */
+        Task<DecodeResult> decode(int inFd, int outFd);
+
+        /**
+         * @brief Encodes a file to <name>_out.txt like Encode, multiplexed with other streams.
+         * @param file The name of the file to encode.
+         * @return Task that finishes when the output is written.
+         */
+        Task<void> encodeFile(std::string file);
+
+        /**
+         * @brief Decodes a text-format file to <name>_decoded.txt like Decode.
+         * @param file The name of the file to decode.
+         * @return Task that finishes when the output is written.
+         */
+        Task<void> decodeFile(std::string file);
+
+        /**
+         * @brief Lazily encodes the chunks handed out by a source.
+         * @param source Returns the next input chunk, or an empty span at the end.
+         * @return Generator yielding each chunk's text records.
+         */
+        Generator<std::span<const std::byte>> encodedChunks(std::function<std::span<const std::byte>()> source);
+
+        /**
+         * @brief Getter for the number of files encodeFile()/decodeFile() could not process.
+         * @return Files that failed to open, read or write.
+         */
+        std::size_t getFailures() const;
+
+    private:
+        /**
+         * @brief Nothing to do; all work happens in the coroutines.
+         */
+        void processFile() override;
+
+        /**
+         * @brief Writes a whole buffer, resuming after each partial write.
+         * @param fd Descriptor to write.
+         * @param data Source.
+         * @param length Bytes to write.
+         * @return Task yielding false on a write error.
+         */
+        Task<bool> writeAll(int fd, const char* data, std::size_t length);
+
+        Scheduler& scheduler;     ///< Event loop for the codec's I/O
+        std::size_t failures = 0; ///< Files that failed in encodeFile()/decodeFile()
+};
+
+#endif
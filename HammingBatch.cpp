@@ -0,0 +1,85 @@
+// Batch mode: runs one operation per manifest entry on a shared work-stealing pool
+// Each file is a task; encode/decode fan out into chunk tasks on the same pool,
+// so small files are picked up by idle workers instead of queueing behind large ones
+
+#include <iostream>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <atomic>
+#include <chrono>
+#include <sys/stat.h>
+#include "Hamming.h"
+#include "ThreadPool.h"
+
+
+//Batch class constructor
+Batch::Batch(std::string manifest, std::string defaultOperation, unsigned threads)
+    : Hamming(manifest), defaultOperation(defaultOperation), threads(ThreadPool::resolveThreads(threads)), failures(0) {
+    processFile();
+}
+Batch::~Batch() {}
+
+
+void Batch::processFile() {
+    std::ifstream manifestFile(fileName, std::ios::in);
+    if (!manifestFile.is_open()) {
+        std::cerr << "Error opening file: " << fileName << std::endl;
+        failures = 1;
+        return;
+    }
+
+    auto start = std::chrono::steady_clock::now();
+    std::atomic<std::size_t> failed(0);
+    std::atomic<std::size_t> bytes(0);
+    std::size_t entries = 0;
+
+    {
+        ThreadPool pool(threads);
+
+        std::string line;
+        while (std::getline(manifestFile, line)) {
+            if (line.empty() || line[0] == '#') continue;
+
+            //"<operation> <file>" or just "<file>"
+            std::istringstream fields(line);
+            std::string first, second;
+            fields >> first >> second;
+            std::string operation = second.empty() ? defaultOperation : first;
+            std::string path = second.empty() ? first : second;
+            if (path.empty()) continue;
+            ++entries;
+
+            pool.submit([&pool, &failed, &bytes, operation, path] {
+                struct stat st;
+                if (stat(path.c_str(), &st) != 0) {
+                    std::cerr << "Error opening file: " << path << std::endl;
+                    ++failed;
+                    return;
+                }
+                bytes += static_cast<std::size_t>(st.st_size);
+
+                if (operation == "encode") ParallelEncode parallelEncode(path, pool);
+                else if (operation == "decode") ParallelDecode parallelDecode(path, pool);
+                else if (operation == "pack") PackedEncode packedEncode(path);
+                else if (operation == "unpack") PackedDecode packedDecode(path);
+                else if (operation == "scrub") Scrub scrub(path);
+                else {
+                    std::cerr << "Error: Unknown operation '" << operation << "' for " << path << std::endl;
+                    ++failed;
+                }
+            });
+        }
+        pool.wait();
+    }
+
+    failures = failed;
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    std::cout << "Batch complete: " << entries << " entries (" << failures << " failed), " << bytes.load()
+              << " input bytes in " << seconds << " s on " << threads << " threads.\n";
+}
+
+//Getter method
+std::size_t Batch::getFailures() const {
+    return failures;
+}
@@ -0,0 +1,595 @@
+// Benchmark suite
+// Generates synthetic printable input, runs encode, decode, error injection and scrub through the
+// Eigen reference, the lookup tables and the bit-sliced code, in memory and through the file
+// classes, and reports the fastest run as MB/s and time stamp counter cycles per plaintext byte,
+// plus the heap allocations of the timed runs when allocation tracking is compiled in
+// Results stream to std::cerr as a table, are written out as JSON and can be read back and
+// compared with a stored baseline
+
+#include <iostream>
+#include <iomanip>
+#include <fstream>
+#include <filesystem>
+#include <string>
+#include <vector>
+#include <chrono>
+#include <memory>
+#include <limits>
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <fcntl.h>
+#include <unistd.h>
+#include "HammingBench.h"
+#include "HammingAlloc.h"
+#include "HammingChannel.h"
+#include "HammingErrorMap.h"
+#include "HammingRandom.h"
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#define HAMMING_HAVE_TSC 1
+#endif
+
+namespace {
+    const char* const injectChannels[] = {"bsc:1e-3", "exact:1", "ge:1e-4,0.1,0,0.5"};
+    const char* const fileChannel = "bsc:1e-3";  //Errors of the decode, replay and scrub inputs (one per codeword at most)
+
+    //Channel flips with at most one per codeword, so corrupted inputs decode and scrub without CRC failures
+    std::vector<std::uint64_t> correctableFlips(std::uint64_t seed, std::uint64_t blocks) {
+        std::vector<std::uint64_t> positions, kept;
+        Channel::create(fileChannel, seed)->corrupt(blocks, positions);
+        for (std::uint64_t position : positions) {
+            if (kept.empty() || kept.back() / 7 != position / 7) kept.push_back(position);
+        }
+        return kept;
+    }
+
+    //Copies a file and writes the copy back to disk, so a timed run does not overlap the kernel's writeback of the copy
+    void restore(const std::string& from, const std::string& to) {
+        std::filesystem::copy_file(from, to, std::filesystem::copy_options::overwrite_existing);
+        int fd = open(to.c_str(), O_RDONLY);
+        if (fd < 0) return;
+        fsync(fd);
+        close(fd);
+    }
+
+    std::uint64_t ticks() {
+#ifdef HAMMING_HAVE_TSC
+        return __rdtsc();
+#else
+        return 0;
+#endif
+    }
+
+    //Reference encoder and decoder: the original per-block Eigen matrix code paths
+    class ReferenceEncode : public Encode {
+        public:
+            ReferenceEncode() : Encode("<bench>", false) {}
+            using Encode::charToBinary;
+            using Encode::splitBinary;
+    };
+
+    class ReferenceDecode : public Decode {
+        public:
+            ReferenceDecode() : Decode("<bench>", false) {}
+            using Decode::parseAndCorrectBlock;
+            using Decode::combineDataAndConvertToChar;
+    };
+
+    //Swallows the completion messages of the file classes while they are timed
+    class NullBuffer : public std::streambuf {
+        protected:
+            int overflow(int c) override { return c; }
+    };
+
+    class MuteStdout {
+        public:
+            MuteStdout() : saved(std::cout.rdbuf(&null)) {}
+            ~MuteStdout() { std::cout.rdbuf(saved); }
+        private:
+            NullBuffer null;
+            std::streambuf* saved;
+    };
+}
+
+
+//Benchmark class constructor
+Benchmark::Benchmark(Options options) : Hamming("<bench>"), options(options), sink(0) {
+    processFile();
+}
+Benchmark::~Benchmark() {}
+
+
+const std::vector<Benchmark::Result>& Benchmark::getResults() const {
+    return results;
+}
+
+void Benchmark::processFile() {
+    //Every pass runs the same measurements in the same order, so results pair up by index
+    std::vector<Result> fastest;
+    for (unsigned pass = 0; pass < std::max(options.passes, 1u); ++pass) {
+        if (options.passes > 1) std::cerr << "Pass " << pass + 1 << " of " << options.passes << ":\n";
+        results.clear();
+        runPass();
+        if (pass == 0) {
+            fastest = results;
+            continue;
+        }
+        for (std::size_t i = 0; i < results.size(); ++i) {
+            Result& best = fastest[i];
+            best.repeats += results[i].repeats;
+            best.allocations = std::max(best.allocations, results[i].allocations);
+            if (results[i].seconds < best.seconds) {
+                best.seconds = results[i].seconds;
+                best.cycles = results[i].cycles;
+            }
+        }
+    }
+    results = fastest;
+}
+
+void Benchmark::runPass() {
+    std::cerr << "kernel  backend              format            bytes        MB/s  cycles/B    runs    allocs\n";
+    //Whole sliced groups per chunk, so every chunk starts on a group boundary
+    const std::size_t chunkSize = std::max<std::size_t>(options.chunkSize / 64 * 64, 64);
+    for (std::size_t size : options.sizes) {
+        std::vector<char> plain(std::min(size, chunkSize));
+        synthesize(0, plain);
+        runMemory(plain, size);
+        runFiles(size, chunkSize);
+    }
+}
+
+void Benchmark::synthesize(std::size_t offset, std::vector<char>& plain) const {
+    //Printable bytes only, so every byte is one 15-byte text record
+    Philox random(options.seed);
+    for (std::size_t i = 0; i < plain.size(); i += 16) {
+        Philox::Block block = random((offset + i) / 16);
+        for (std::size_t k = 0; k < 16 && i + k < plain.size(); ++k) {
+            plain[i + k] = static_cast<char>(0x20 + (block[k / 4] >> (8 * (k % 4)) & 0xFF) % 95);
+        }
+    }
+}
+
+void Benchmark::runMemory(const std::vector<char>& plain, std::size_t size) {
+    const std::size_t chunk = plain.size();
+    const std::size_t blocks = chunk * 2;
+    const std::size_t groups = (blocks + 63) / 64;
+    const bool text = selected("encode", "text") || selected("decode", "text");
+
+    //Inputs larger than the chunk run as consecutive passes over the chunk's buffers
+    auto chunked = [&](auto&& kernel) {
+        for (std::size_t done = 0; done < size; done += chunk) kernel(std::min(chunk, size - done));
+    };
+
+    //Clean packed codewords, and a copy corrupted for the decoders
+    std::vector<unsigned char> packed(blocks);
+    for (std::size_t i = 0; i < chunk; ++i) {
+        unsigned char ch = static_cast<unsigned char>(plain[i]);
+        packed[2 * i] = encodeTable[ch >> 4];
+        packed[2 * i + 1] = encodeTable[ch & 0x0F];
+    }
+    std::vector<unsigned char> received(packed);
+    for (std::uint64_t position : correctableFlips(options.seed, blocks)) received[position / 7] ^= static_cast<unsigned char>(0x40 >> (position % 7));
+
+    //Text records take 15 bytes per plaintext byte, so they only exist when a text format runs
+    std::vector<char> receivedText;
+    if (text) {
+        receivedText.resize(chunk * 15);
+        for (std::size_t i = 0; i < blocks; ++i) std::copy(codewordText[received[i]], codewordText[received[i]] + 7, &receivedText[i / 2 * 15 + i % 2 * 7]);
+        for (std::size_t i = 0; i < chunk; ++i) receivedText[i * 15 + 14] = '\n';
+    }
+
+    //Bit-sliced columns: lane l of group g is codeword 64 * g + l
+    std::vector<std::uint64_t> messages(groups * 4, 0), sliced(groups * 7, 0);
+    for (std::size_t i = 0; i < blocks; ++i) {
+        std::uint64_t lane = static_cast<std::uint64_t>(1) << (i % 64);
+        unsigned nibble = correctTable[packed[i]];
+        for (int b = 0; b < 4; ++b) {
+            if (nibble & (8 >> b)) messages[i / 64 * 4 + b] |= lane;
+        }
+        for (int j = 0; j < 7; ++j) {
+            if (received[i] & (0x40 >> j)) sliced[i / 64 * 7 + j] |= lane;
+        }
+    }
+
+    std::vector<char> out(text ? chunk * 15 : chunk);
+    std::vector<unsigned char> codewords(blocks);
+    std::vector<std::uint64_t> columns(groups * 7);
+
+    if (size <= options.eigenMax && selected("encode", "text")) {
+        ReferenceEncode reference;
+        measure("encode", "eigen", "text", size, [&] {
+            chunked([&](std::size_t n) {
+                char* record = out.data();
+                for (std::size_t i = 0; i < n; ++i) {
+                    auto [high, low] = reference.splitBinary(reference.charToBinary(plain[i]));
+                    Eigen::Matrix<int, 1, 7> first = reference.encodeMessage(high), second = reference.encodeMessage(low);
+                    for (int j = 0; j < 7; ++j) record[j] = static_cast<char>('0' + first(0, j));
+                    for (int j = 0; j < 7; ++j) record[7 + j] = static_cast<char>('0' + second(0, j));
+                    record[14] = '\n';
+                    record += 15;
+                }
+                sink += static_cast<unsigned char>(out[n * 15 - 2]);
+            });
+        });
+    }
+    if (selected("encode", "text")) {
+        measure("encode", "table", "text", size, [&] {
+            chunked([&](std::size_t n) { sink += encodeToText(plain.data(), n, out.data()); });
+        });
+    }
+    if (selected("encode", "packed")) {
+        measure("encode", "table", "packed", size, [&] {
+            chunked([&](std::size_t n) {
+                for (std::size_t i = 0; i < n; ++i) {
+                    unsigned char ch = static_cast<unsigned char>(plain[i]);
+                    codewords[2 * i] = encodeTable[ch >> 4];
+                    codewords[2 * i + 1] = encodeTable[ch & 0x0F];
+                }
+                sink += codewords[2 * n - 1];
+            });
+        });
+    }
+    if (selected("encode", "sliced")) {
+        measure("encode", "bitsliced", "sliced", size, [&] {
+            chunked([&](std::size_t n) {
+                std::size_t count = (2 * n + 63) / 64;
+                for (std::size_t g = 0; g < count; ++g) encodeSliced(&messages[g * 4], &columns[g * 7]);
+                sink += columns[count * 7 - 1];
+            });
+        });
+    }
+
+    if (size <= options.eigenMax && selected("decode", "text")) {
+        ReferenceDecode reference;
+        std::string line;
+        DecodeStats stats;
+        measure("decode", "eigen", "text", size, [&] {
+            chunked([&](std::size_t n) {
+                for (std::size_t i = 0; i < n; ++i) {
+                    line.assign(&receivedText[i * 15], 14);
+                    auto [first, second] = reference.parseAndCorrectBlock(line, stats);
+                    out[i] = reference.combineDataAndConvertToChar(first, second);
+                }
+                sink += static_cast<unsigned char>(out[n - 1]);
+            });
+        });
+    }
+    if (selected("decode", "text")) {
+        measure("decode", "table", "text", size, [&] {
+            chunked([&](std::size_t n) {
+                DecodeStats stats;
+                sink += decodeFromText(receivedText.data(), n * 15, out.data(), stats) + stats.corrected;
+            });
+        });
+    }
+    if (selected("decode", "packed")) {
+        measure("decode", "table", "packed", size, [&] {
+            chunked([&](std::size_t n) {
+                for (std::size_t i = 0; i < n; ++i) {
+                    out[i] = static_cast<char>((correctTable[received[2 * i]] << 4) | correctTable[received[2 * i + 1]]);
+                }
+                sink += static_cast<unsigned char>(out[n - 1]);
+            });
+        });
+    }
+    if (selected("decode", "sliced")) {
+        measure("decode", "bitsliced", "sliced", size, [&] {
+            chunked([&](std::size_t n) {
+                std::size_t count = (2 * n + 63) / 64;
+                for (std::size_t g = 0; g < count; ++g) {
+                    std::uint64_t word[7];
+                    std::copy(&sliced[g * 7], &sliced[g * 7] + 7, word);
+                    correctSliced(word);
+                    for (int b = 0; b < 4; ++b) columns[g * 4 + b] = word[sliceDataColumn[b]];
+                }
+                sink += columns[count * 4 - 1];
+            });
+        });
+    }
+
+    if (selected("inject", "packed")) {
+        codewords = packed;
+        for (const char* spec : injectChannels) {
+            std::unique_ptr<Channel> channel = Channel::create(spec, options.seed);
+            measure("inject", spec, "packed", size, [&] {
+                chunked([&](std::size_t n) { sink += channel->apply(codewords.data(), 2 * n); });
+            });
+        }
+
+        ErrorMap errors;
+        std::unique_ptr<Channel> channel = Channel::create(fileChannel, options.seed);
+        errors.record(*channel, blocks);
+        measure("inject", "overlay", "packed", size, [&] {
+            chunked([&](std::size_t n) {
+                std::size_t cursor = 0;
+                sink += errors.apply(0, codewords.data(), 2 * n, cursor);
+            });
+        });
+    }
+}
+
+void Benchmark::runFiles(std::size_t size, std::size_t chunkSize) {
+    bool textFile = selected("", "text-file"), packedFile = selected("", "packed-file");
+    if (!textFile && !packedFile) return;
+
+    namespace fs = std::filesystem;
+    //Sizes are zero-padded so every size names its files with strings of the same length: a name
+    //that only outgrows the short-string buffer on large inputs would look like allocation growth
+    std::string digits = std::to_string(size);
+    std::string stem = (fs::path(options.directory) / ("bench_" + std::string(20 - digits.size(), '0') + digits)).string();
+    std::string input = stem + ".txt", encoded = stem + "_out.txt", container = stem + ".hmc";
+    std::string faultMap = stem + "_faults.txt", scrubbed = stem + "_scrub";
+    std::string corruptText = stem + "_e_out.txt", corruptContainer = stem + "_e.hmc";
+
+    {
+        std::ofstream file(input, std::ios::out | std::ios::binary | std::ios::trunc);
+        std::vector<char> plain;
+        for (std::size_t offset = 0; file && offset < size; offset += chunkSize) {
+            plain.resize(std::min(chunkSize, size - offset));
+            synthesize(offset, plain);
+            file.write(plain.data(), static_cast<std::streamsize>(plain.size()));
+        }
+    }
+    {
+        //Fault map of the decode and scrub inputs
+        std::ofstream faults(faultMap, std::ios::out | std::ios::trunc);
+        for (std::uint64_t position : correctableFlips(options.seed, static_cast<std::uint64_t>(size) * 2)) faults << position << '\n';
+    }
+    if (!fs::exists(input) || !fs::exists(faultMap)) {
+        std::cerr << "Error creating benchmark files in " << options.directory << std::endl;
+        return;
+    }
+
+    MuteStdout mute;
+    ParallelEncode textEncoder(input, 1);
+    PackedEncode packedEncoder(input);
+    {
+        FaultMapReader textFaults(faultMap), packedFaults(faultMap);
+        ErrorEncode(encoded, textFaults);
+        ErrorEncode(container, packedFaults);
+    }
+
+    if (textFile) {
+        if (selected("encode", "text-file")) measure("encode", "table", "text-file", size, [&] { ParallelEncode(input, 1); });
+        if (selected("decode", "text-file")) measure("decode", "table", "text-file", size, [&] { ParallelDecode(corruptText, 1); });
+        if (size <= options.serialMax && selected("encode", "text-file")) measure("encode", "serial", "text-file", size, [&] { Encode encoder(input); });
+        if (size <= options.serialMax && selected("decode", "text-file")) {
+            measure("decode", "serial", "text-file", size, [&] { Decode decoder(corruptText, Decode::Verbosity::Quiet); });
+        }
+        if (selected("inject", "text-file")) {
+            measure("inject", fileChannel, "text-file", size, [&] {
+                ErrorEncode(encoded, options.seed, fileChannel, ErrorEncode::Input::Encoded);
+            });
+            measure("inject", "replay", "text-file", size, [&] {
+                FaultMapReader faults(faultMap);
+                ErrorEncode(encoded, faults);
+            });
+        }
+        if (selected("scrub", "text-file")) {
+            measure("scrub", "table", "text-file", size, [&] { Scrub(scrubbed + ".txt"); },
+                    [&] { restore(corruptText, scrubbed + ".txt"); });
+        }
+    }
+    if (packedFile) {
+        if (selected("encode", "packed-file")) measure("encode", "table", "packed-file", size, [&] { PackedEncode encoder(input); });
+        if (selected("decode", "packed-file")) measure("decode", "table", "packed-file", size, [&] { PackedDecode decoder(corruptContainer); });
+        if (selected("inject", "packed-file")) {
+            measure("inject", "replay", "packed-file", size, [&] {
+                FaultMapReader faults(faultMap);
+                ErrorEncode(container, faults);
+            });
+        }
+        if (selected("scrub", "packed-file")) {
+            measure("scrub", "table", "packed-file", size, [&] { Scrub(scrubbed + ".hmc"); },
+                    [&] { restore(corruptContainer, scrubbed + ".hmc"); });
+        }
+    }
+
+    for (const std::string& name : {input, encoded, container, faultMap, corruptText, corruptContainer, stem + "_e_out_decoded.txt",
+                                    stem + "_e_decoded.txt", scrubbed + ".txt", scrubbed + ".hmc"}) {
+        std::remove(name.c_str());
+    }
+}
+
+bool Benchmark::selected(const std::string& kernel, const std::string& format) const {
+    auto allows = [](const std::vector<std::string>& filter, const std::string& name) {
+        return name.empty() || filter.empty() || std::find(filter.begin(), filter.end(), name) != filter.end();
+    };
+    return allows(options.kernels, kernel) && allows(options.formats, format);
+}
+
+void Benchmark::measure(const std::string& kernel, const std::string& backend, const std::string& format, std::size_t bytes,
+                        const std::function<void()>& body, const std::function<void()>& setup) {
+    Result result;
+    result.kernel = kernel;
+    result.backend = backend;
+    result.format = format;
+    result.bytes = bytes;
+    result.seconds = std::numeric_limits<double>::infinity();
+
+    //One untimed run warms buffers, caches and branch predictors (and makes the one-time allocations);
+    //then at least three timed runs, the fastest being the least disturbed by the rest of the system
+    if (setup) setup();
+    body();
+    double total = 0;
+    std::uint64_t allocations = 0;
+    while (result.repeats < 3 || total < options.minTime) {
+        if (setup) setup();
+        std::uint64_t allocationsBefore = AllocTracker::counts().allocations;
+        auto start = std::chrono::steady_clock::now();
+        std::uint64_t first = ticks();
+        body();
+        std::uint64_t last = ticks();
+        double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        allocations += AllocTracker::counts().allocations - allocationsBefore;
+
+        total += seconds;
+        ++result.repeats;
+        if (seconds < result.seconds) {
+            result.seconds = seconds;
+#ifdef HAMMING_HAVE_TSC
+            result.cycles = static_cast<double>(last - first);
+#endif
+        }
+    }
+    if (AllocTracker::tracking) result.allocations = static_cast<double>(allocations) / static_cast<double>(result.repeats);
+    results.push_back(result);
+
+    std::cerr << std::left << std::setw(8) << kernel << std::setw(21) << backend << std::setw(12) << format << std::right
+              << std::setw(11) << bytes << std::fixed << std::setprecision(1) << std::setw(12) << bytes / result.seconds / 1e6
+              << std::setprecision(2) << std::setw(10) << (result.cycles < 0 ? 0.0 : result.cycles / bytes)
+              << std::setw(8) << result.repeats << std::setprecision(1) << std::setw(10) << result.allocations << "\n" << std::defaultfloat;
+}
+
+bool Benchmark::allocationFree() const {
+    bool clean = true;
+    for (const Result& result : results) {
+        bool steadyState = (result.kernel == "encode" || result.kernel == "decode")
+                        && (result.format == "text" || result.format == "packed" || result.format == "sliced");
+        if (steadyState && result.allocations > 0) {
+            std::cerr << "Error: " << result.kernel << "/" << result.backend << "/" << result.format << " at " << result.bytes
+                      << " bytes allocates " << std::fixed << std::setprecision(1) << result.allocations << " times per run once warmed up."
+                      << std::defaultfloat << std::endl;
+            clean = false;
+        }
+    }
+    return clean;
+}
+
+bool Benchmark::allocationsBounded() const {
+    bool bounded = true;
+    for (const Result& result : results) {
+        if (result.allocations < 0) continue;
+        const Result* smallest = &result;
+        for (const Result& other : results) {
+            if (other.kernel == result.kernel && other.backend == result.backend && other.format == result.format
+                && other.allocations >= 0 && other.bytes < smallest->bytes) {
+                smallest = &other;
+            }
+        }
+        //Allocations are averaged over the timed runs; half an allocation absorbs a rare extra one
+        if (result.allocations > smallest->allocations + 0.5) {
+            std::cerr << "Error: " << result.kernel << "/" << result.backend << "/" << result.format << std::fixed << std::setprecision(1)
+                      << " allocates " << result.allocations << " times per run at " << result.bytes << " bytes but "
+                      << smallest->allocations << " at " << smallest->bytes << " bytes." << std::defaultfloat << std::endl;
+            bounded = false;
+        }
+    }
+    return bounded;
+}
+
+void Benchmark::writeJson(std::ostream& out) const {
+#ifdef HAMMING_HAVE_TSC
+    const bool tsc = true;
+#else
+    const bool tsc = false;
+#endif
+    out << "{\n  \"benchmark\": \"hamming\",\n  \"tsc\": " << (tsc ? "true" : "false") << ",\n  \"min_time\": " << options.minTime
+        << ",\n  \"results\": [\n";
+    for (std::size_t i = 0; i < results.size(); ++i) {
+        const Result& result = results[i];
+        out << "    {\"kernel\": \"" << result.kernel << "\", \"backend\": \"" << result.backend << "\", \"format\": \"" << result.format
+            << "\", \"bytes\": " << result.bytes << ", \"repeats\": " << result.repeats << ", \"seconds\": " << std::setprecision(6)
+            << result.seconds << ", \"mb_per_s\": " << result.bytes / result.seconds / 1e6 << ", \"cycles_per_byte\": ";
+        if (result.cycles < 0) out << "null";
+        else out << result.cycles / result.bytes;
+        out << ", \"allocs_per_run\": ";
+        if (result.allocations < 0) out << "null, \"allocs_per_mb\": null";
+        else out << result.allocations << ", \"allocs_per_mb\": " << result.allocations / (result.bytes / 1e6);
+        out << "}" << (i + 1 < results.size() ? "," : "") << "\n";
+    }
+    out << "  ]\n}\n" << std::defaultfloat;
+}
+
+bool Benchmark::readJson(const std::string& path, std::vector<Result>& results) {
+    std::ifstream in(path);
+    if (!in.is_open()) {
+        std::cerr << "Error opening file: " << path << std::endl;
+        return false;
+    }
+
+    //writeJson() puts each result on its own line, so fields are looked up by key within the line
+    auto text = [](const std::string& line, const std::string& key) {
+        std::size_t at = line.find("\"" + key + "\": \"");
+        if (at == std::string::npos) return std::string();
+        at += key.size() + 5;
+        return line.substr(at, line.find('"', at) - at);
+    };
+    auto number = [](const std::string& line, const std::string& key) {
+        std::size_t at = line.find("\"" + key + "\": ");
+        if (at == std::string::npos) return -1.0;
+        const char* start = line.c_str() + at + key.size() + 4;
+        char* end;
+        double value = std::strtod(start, &end);
+        return end == start ? -1.0 : value;
+    };
+
+    std::string line;
+    std::size_t before = results.size();
+    while (std::getline(in, line)) {
+        if (line.find("\"kernel\": ") == std::string::npos) continue;
+        Result result;
+        result.kernel = text(line, "kernel");
+        result.backend = text(line, "backend");
+        result.format = text(line, "format");
+        result.bytes = static_cast<std::size_t>(number(line, "bytes"));
+        result.repeats = static_cast<std::size_t>(number(line, "repeats"));
+        result.seconds = number(line, "seconds");
+        double cyclesPerByte = number(line, "cycles_per_byte");
+        result.cycles = cyclesPerByte < 0 ? -1 : cyclesPerByte * result.bytes;
+        result.allocations = number(line, "allocs_per_run");
+        if (result.kernel.empty() || result.bytes == 0 || result.seconds <= 0) {
+            std::cerr << "Error: malformed result in " << path << ": " << line << std::endl;
+            return false;
+        }
+        results.push_back(result);
+    }
+    if (results.size() == before) {
+        std::cerr << "Error: no results in " << path << std::endl;
+        return false;
+    }
+    return true;
+}
+
+std::vector<Benchmark::Result> Benchmark::compare(const std::vector<Result>& baseline, const std::vector<Result>& current,
+                                                  const std::map<std::string, double>& thresholds, std::ostream& out) {
+    auto tolerance = [&](const Result& result) {
+        double percent = 0;
+        for (const std::string& name : {std::string(), result.kernel, result.backend, result.format}) {
+            auto found = thresholds.find(name);
+            if (found != thresholds.end()) percent = std::max(percent, found->second);
+        }
+        return percent;
+    };
+
+    out << "kernel  backend              format            bytes   base MB/s    now MB/s   change   allowed\n";
+    std::vector<Result> regressions;
+    for (const Result& base : baseline) {
+        auto match = std::find_if(current.begin(), current.end(), [&](const Result& result) {
+            return result.kernel == base.kernel && result.backend == base.backend && result.format == base.format && result.bytes == base.bytes;
+        });
+        out << std::left << std::setw(8) << base.kernel << std::setw(21) << base.backend << std::setw(12) << base.format << std::right
+            << std::setw(11) << base.bytes << std::fixed << std::setprecision(1) << std::setw(12) << base.bytes / base.seconds / 1e6;
+        //A result the baseline has but this run lacks fails too, or dropping a kernel would pass the check
+        if (match == current.end()) {
+            out << "     missing" << std::setw(28) << "MISSING\n" << std::defaultfloat;
+            regressions.push_back(base);
+            continue;
+        }
+
+        //Throughput is bytes / seconds, so the change in throughput is the inverse change in time
+        double change = 100.0 * (base.seconds / match->seconds - 1.0);
+        double allowed = tolerance(base);
+        out << std::setw(12) << match->bytes / match->seconds / 1e6 << std::showpos << std::setw(8) << change << "%"
+            << std::noshowpos << std::setw(8) << allowed << "%";
+        if (change < -allowed) {
+            out << "  REGRESSION";
+            regressions.push_back(*match);
+        }
+        out << "\n" << std::defaultfloat;
+    }
+    return regressions;
+}
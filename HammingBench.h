@@ -0,0 +1,183 @@
+/* Colton Criswell and Zach Hamby
+ * Final Project - CS-300
+ */
+
+#ifndef HAMMING_BENCH_H
+#define HAMMING_BENCH_H
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <map>
+#include <ostream>
+#include <string>
+#include <vector>
+#include "Hamming.h"
+
+/**
+ * @class Benchmark
+ * @brief Derived class for timing every kernel on every backend and format.
+ *
+ * Synthetic printable input of each requested size is encoded, decoded, corrupted and scrubbed
+ * through each backend: the Eigen matrix reference, the lookup tables and the bit-sliced code
+ * (64 codewords per logic operation). In-memory formats are text records, packed codewords and
+ * bit-sliced columns, built for at most Options::chunkSize bytes and run chunk by chunk over larger
+ * inputs, so memory stays bounded whatever the size; file formats run the real file classes (ParallelEncode/Decode on one
+ * thread, the serial Encode/Decode, PackedEncode/Decode, ErrorEncode, Scrub) on files in a work directory, warm in the page
+ * cache. Every measurement makes one untimed warm-up run, then repeats until a minimum time has
+ * passed and keeps the fastest run; with several passes over the suite each result keeps its
+ * fastest pass. Throughput and cycles are per plaintext byte, so formats compare directly. Built with
+ * HAMMING_ALLOC_TRACK (as `make bench` does), every result also records the heap allocations of
+ * a warmed-up run: in-memory encode and decode kernels must not allocate at all, and no result may
+ * allocate more per run than it did on the smallest input, since allocations that grow with the
+ * input (per chunk or per record) cost time in proportion to it.
+ */
+class Benchmark : public Hamming {
+
+    public:
+        /**
+         * @struct Options
+         * @brief What to run and for how long.
+         */
+        struct Options {
+            std::vector<std::size_t> sizes = {1 << 10, 64 << 10, 1 << 20, 16 << 20}; ///< Plaintext bytes per input
+            std::vector<std::string> kernels;            ///< Kernels to run (empty = all): encode, decode, inject, scrub
+            std::vector<std::string> formats;            ///< Formats to run (empty = all): text, packed, sliced, text-file, packed-file
+            double minTime = 0.2;                        ///< Seconds to repeat each measurement for
+            std::size_t eigenMax = 16 << 20;             ///< Largest input given to the Eigen reference
+            std::size_t serialMax = 1 << 20;             ///< Largest input given to the serial Encode and Decode classes (Encode keeps every codeword)
+            std::string directory = ".";                 ///< Where file formats put their files
+            std::uint64_t seed = 0x5EED;                 ///< Seed of the synthetic input and the channels
+            unsigned passes = 1;                         ///< Times the whole suite runs; each result keeps its fastest pass
+            std::size_t chunkSize = 4 << 20;             ///< Plaintext bytes held in memory at once; larger inputs run chunk by chunk
+        };
+
+        /**
+         * @struct Result
+         * @brief One measurement.
+         */
+        struct Result {
+            std::string kernel;        ///< encode, decode, inject or scrub
+            std::string backend;       ///< eigen, table, bitsliced, serial (the Encode and Decode classes), or the channel used for injection
+            std::string format;        ///< text, packed, sliced, text-file or packed-file
+            std::size_t bytes = 0;     ///< Plaintext bytes per run
+            std::size_t repeats = 0;   ///< Runs timed
+            double seconds = 0;        ///< Fastest run
+            double cycles = -1;        ///< Time stamp counter ticks of the fastest run (-1 without a counter)
+            double allocations = -1;   ///< Heap allocations per timed run (-1 without allocation tracking)
+        };
+
+        /**
+         * @brief Constructor for Benchmark class; runs every selected measurement.
+         * @param options What to run.
+         */
+        Benchmark(Options options);
+
+        /**
+         * @brief Destructor for Benchmark class.
+         */
+        ~Benchmark();
+
+        /**
+         * @brief Getter for the results.
+         * @return One entry per measurement, in the order run.
+         */
+        const std::vector<Result>& getResults() const;
+
+        /**
+         * @brief Checks that no in-memory encode or decode kernel allocated once warmed up.
+         * @return True if none did (always true without allocation tracking); offenders are printed to std::cerr.
+         */
+        bool allocationFree() const;
+
+        /**
+         * @brief Checks that allocations per run do not grow with the input size.
+         * @return True if no result allocates more per run than the same kernel, backend and format did on the
+         *         smallest input (always true without allocation tracking); offenders are printed to std::cerr.
+         */
+        bool allocationsBounded() const;
+
+        /**
+         * @brief Writes the results as JSON, one result object per line.
+         * @param out Destination stream.
+         */
+        void writeJson(std::ostream& out) const;
+
+        /**
+         * @brief Reads results written by writeJson().
+         * @param path JSON file.
+         * @param results Receives one entry per result line.
+         * @return True if the file was read and held at least one result.
+         */
+        static bool readJson(const std::string& path, std::vector<Result>& results);
+
+        /**
+         * @brief Compares results with a baseline, matching them by kernel, backend, format and size.
+         * @param baseline Reference results.
+         * @param current Results to check.
+         * @param thresholds Slowdown in percent tolerated before a result counts as a regression:
+         *                   keyed by kernel, backend or format name, "" for the rest; the largest match applies.
+         * @param out Destination of the comparison table.
+         * @return The current results that regressed, plus the baseline entries missing from current.
+         */
+        static std::vector<Result> compare(const std::vector<Result>& baseline, const std::vector<Result>& current,
+                                           const std::map<std::string, double>& thresholds, std::ostream& out);
+
+    private:
+        /**
+         * @brief Runs the suite for the requested number of passes and keeps each result's fastest pass.
+         */
+        void processFile() override;
+
+        /**
+         * @brief Runs every selected measurement once, printing each result to std::cerr as it finishes.
+         */
+        void runPass();
+
+        /**
+         * @brief Fills a buffer with the synthetic printable input found at an offset.
+         * @param offset Input offset of the buffer's first byte (a multiple of 16).
+         * @param plain Buffer to fill.
+         */
+        void synthesize(std::size_t offset, std::vector<char>& plain) const;
+
+        /**
+         * @brief Times the in-memory kernels on one input.
+         * @param plain The input's first chunk; larger inputs run as repeated passes over it.
+         * @param size Plaintext bytes per run.
+         */
+        void runMemory(const std::vector<char>& plain, std::size_t size);
+
+        /**
+         * @brief Times the file kernels on one input.
+         * @param size Plaintext bytes of the input file.
+         * @param chunkSize Bytes generated and written at a time.
+         */
+        void runFiles(std::size_t size, std::size_t chunkSize);
+
+        /**
+         * @brief Checks whether a kernel and format were selected.
+         * @param kernel Kernel name.
+         * @param format Format name.
+         * @return True if both pass the filters.
+         */
+        bool selected(const std::string& kernel, const std::string& format) const;
+
+        /**
+         * @brief Repeats a kernel until the minimum time has passed and records the fastest run.
+         * @param kernel Kernel name.
+         * @param backend Backend name.
+         * @param format Format name.
+         * @param bytes Plaintext bytes per run.
+         * @param body The timed work.
+         * @param setup Untimed work before every run (e.g. restoring a file the kernel modifies).
+         */
+        void measure(const std::string& kernel, const std::string& backend, const std::string& format, std::size_t bytes,
+                     const std::function<void()>& body, const std::function<void()>& setup = nullptr);
+
+        Options options;              ///< What to run
+        std::vector<Result> results;  ///< One entry per measurement
+        std::uint64_t sink;           ///< Folds kernel outputs so the optimizer keeps them
+};
+
+#endif
@@ -0,0 +1,151 @@
+// Channel models for error injection
+// Binary symmetric and Gilbert-Elliott channels skip-sample geometric gaps between flips,
+// so the work per call follows the number of errors rather than the number of bits
+// The exact-k channel draws k distinct positions per codeword from counter-based streams
+
+#include <iostream>
+#include <string>
+#include <vector>
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+#include "HammingChannel.h"
+
+namespace {
+    //next + 1 + gap without overflowing; UINT64_MAX stands for "never"
+    std::uint64_t advance(std::uint64_t next, std::uint64_t gap) {
+        if (gap >= UINT64_MAX - next - 1) return UINT64_MAX;
+        return next + 1 + gap;
+    }
+
+    bool parseProbability(const char*& p, double& value) {
+        char* end;
+        value = std::strtod(p, &end);
+        if (end == p || !(value >= 0.0 && value <= 1.0)) return false;
+        p = end;
+        return true;
+    }
+}
+
+
+//Channel class constructor
+Channel::Channel(std::uint64_t seed, std::uint64_t stream) : random(seed, stream), counter(0), seed(seed), stream(stream) {}
+Channel::~Channel() {}
+
+
+std::size_t Channel::apply(unsigned char* codewords, std::size_t count) {
+    //Room for one flip per codeword, far above usable error rates, so the flip count of a chunk does
+    //not regrow the vector at random points of a long run
+    scratch.clear();
+    if (scratch.capacity() < count) scratch.reserve(count);
+    corrupt(count, scratch);
+    for (std::uint64_t position : scratch) {
+        codewords[position / 7] ^= static_cast<unsigned char>(0x40 >> (position % 7));
+    }
+    return scratch.size();
+}
+
+std::uint64_t Channel::skip(double logKeep) {
+    if (logKeep == 0.0) return UINT64_MAX;
+    if (std::isinf(logKeep)) return 0;
+
+    //Inverse transform of a uniform in (0, 1]: floor(log(u) / log(1 - p))
+    Philox::Block block = random(counter++);
+    double u = 1.0 - Philox::toUnit(block[0], block[1]);
+    double gap = std::floor(std::log(u) / logKeep);
+    return gap >= 1.8e19 ? UINT64_MAX : static_cast<std::uint64_t>(gap);
+}
+
+std::unique_ptr<Channel> Channel::create(const std::string& spec, std::uint64_t seed, std::uint64_t stream) {
+    std::string kind = spec.substr(0, spec.find(':'));
+    const char* p = spec.c_str() + (spec.find(':') == std::string::npos ? spec.size() : kind.size() + 1);
+
+    if (kind == "bsc") {
+        double rate;
+        if (parseProbability(p, rate) && *p == '\0') return std::make_unique<BinarySymmetricChannel>(rate, seed, stream);
+    } else if (kind == "ge") {
+        double values[4];
+        bool valid = true;
+        for (int i = 0; i < 4 && valid; ++i) {
+            valid = parseProbability(p, values[i]) && *p == (i == 3 ? '\0' : ',');
+            if (i < 3) ++p;
+        }
+        if (valid) return std::make_unique<GilbertElliottChannel>(values[0], values[1], values[2], values[3], seed, stream);
+    } else if (kind == "exact") {
+        char* end;
+        unsigned long k = std::strtoul(p, &end, 10);
+        if (end != p && *end == '\0' && k <= 7) return std::make_unique<ExactChannel>(static_cast<unsigned>(k), seed, stream);
+    }
+
+    std::cerr << "Error: invalid channel '" << spec << "' (expected bsc:<p>, ge:<pGB>,<pBG>,<eG>,<eB> or exact:<k>)." << std::endl;
+    return nullptr;
+}
+
+
+//BinarySymmetricChannel class constructor
+BinarySymmetricChannel::BinarySymmetricChannel(double p, std::uint64_t seed, std::uint64_t stream)
+    : Channel(seed, stream), logKeep(std::log1p(-p)) {
+    next = skip(logKeep);
+}
+
+void BinarySymmetricChannel::corrupt(std::uint64_t blocks, std::vector<std::uint64_t>& positions) {
+    std::uint64_t bits = blocks * 7;
+    while (next < bits) {
+        positions.push_back(next);
+        next = advance(next, skip(logKeep));
+    }
+    if (next != UINT64_MAX) next -= bits;
+}
+
+
+//GilbertElliottChannel class constructor
+GilbertElliottChannel::GilbertElliottChannel(double pGoodToBad, double pBadToGood, double pErrorGood, double pErrorBad,
+                                             std::uint64_t seed, std::uint64_t stream)
+    : Channel(seed, stream), logStay{std::log1p(-pGoodToBad), std::log1p(-pBadToGood)},
+      logKeep{std::log1p(-pErrorGood), std::log1p(-pErrorBad)} {
+    enter(false);
+}
+
+void GilbertElliottChannel::enter(bool toBad) {
+    bad = toBad;
+    stateLeft = advance(0, skip(logStay[bad]));
+    next = skip(logKeep[bad]);
+}
+
+void GilbertElliottChannel::corrupt(std::uint64_t blocks, std::vector<std::uint64_t>& positions) {
+    std::uint64_t bits = blocks * 7;
+    for (std::uint64_t position = 0; position < bits;) {
+        //Flips inside the part of the current state that overlaps these bits
+        std::uint64_t span = std::min(stateLeft, bits - position);
+        while (next < span) {
+            positions.push_back(position + next);
+            next = advance(next, skip(logKeep[bad]));
+        }
+        if (next != UINT64_MAX) next -= span;
+        if (stateLeft != UINT64_MAX) stateLeft -= span;
+        position += span;
+
+        //Gaps are memoryless, so the pending flip of the old state is simply redrawn
+        if (stateLeft == 0) enter(!bad);
+    }
+}
+
+
+//ExactChannel class constructor
+ExactChannel::ExactChannel(unsigned k, std::uint64_t seed, std::uint64_t stream) : Channel(seed, stream), k(k) {}
+
+void ExactChannel::corrupt(std::uint64_t blocks, std::vector<std::uint64_t>& positions) {
+    for (std::uint64_t i = 0; i < blocks; ++i, ++counter) {
+        //Partial Fisher-Yates shuffle of the seven columns; positions come out sorted per codeword
+        unsigned char columns[7] = {0, 1, 2, 3, 4, 5, 6};
+        unsigned char mask = 0;
+        for (unsigned j = 0; j < k; ++j) {
+            unsigned pick = j + Philox(seed, stream + j).below(counter, 7 - j);
+            std::swap(columns[j], columns[pick]);
+            mask |= static_cast<unsigned char>(0x40 >> columns[j]);
+        }
+        for (unsigned column = 0; column < 7; ++column) {
+            if (mask & (0x40 >> column)) positions.push_back(7 * i + column);
+        }
+    }
+}
@@ -0,0 +1,168 @@
+/* Colton Criswell and Zach Hamby
+ * Final Project - CS-300
+ */
+
+#ifndef HAMMING_CHANNEL_H
+#define HAMMING_CHANNEL_H
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+#include "HammingRandom.h"
+
+/**
+ * @class Channel
+ * @brief Base class for channel models that corrupt a stream of 7-bit codewords.
+ *
+ * Bits are numbered across the stream: bit j of codeword i is position 7 * i + j (j = 0 is the
+ * first column, bit 6 of a packed codeword byte). A channel hands out the positions it flips, so
+ * the cost of a low-error channel follows the number of errors, not the number of bits. Each
+ * channel keeps its own position in its Philox stream, so successive calls continue the stream.
+ */
+class Channel {
+
+    public:
+        /**
+         * @brief Constructor for Channel class.
+         * @param seed Seed of the error pattern.
+         * @param stream Independent stream number (e.g. one per thread).
+         */
+        Channel(std::uint64_t seed, std::uint64_t stream);
+
+        /**
+         * @brief Virtual destructor for Channel class.
+         */
+        virtual ~Channel();
+
+        /**
+         * @brief Appends the flipped bit positions of the next codewords of the stream.
+         * @param blocks Number of codewords passing through the channel.
+         * @param positions Receives the flipped positions (ascending, relative to the first of these codewords).
+         */
+        virtual void corrupt(std::uint64_t blocks, std::vector<std::uint64_t>& positions) = 0;
+
+        /**
+         * @brief Passes packed codewords (one per byte, bit 6 = first column) through the channel.
+         * @param codewords The codewords, corrupted in place.
+         * @param count Number of codewords.
+         * @return Number of bits flipped.
+         */
+        std::size_t apply(unsigned char* codewords, std::size_t count);
+
+        /**
+         * @brief Builds a channel from a specification.
+         *
+         * Accepted forms: "bsc:<p>" (independent flips with bit error rate p),
+         * "ge:<pGoodToBad>,<pBadToGood>,<pErrorGood>,<pErrorBad>" (Gilbert-Elliott bursts)
+         * and "exact:<k>" (exactly k distinct bits of every codeword).
+         * @param spec The specification.
+         * @param seed Seed of the error pattern.
+         * @param stream Independent stream number.
+         * @return The channel, or nullptr if the specification is invalid.
+         */
+        static std::unique_ptr<Channel> create(const std::string& spec, std::uint64_t seed, std::uint64_t stream = 0);
+
+    protected:
+        /**
+         * @brief Draws a geometric gap: the number of bits passed over before the next event.
+         * @param logKeep log(1 - p) of the per-bit event probability p.
+         * @return The gap (UINT64_MAX if p = 0, i.e. the event never happens).
+         */
+        std::uint64_t skip(double logKeep);
+
+        Philox random;         ///< Counter-based generator
+        std::uint64_t counter; ///< Next counter value of the stream
+        std::uint64_t seed;    ///< Seed of the error pattern
+        std::uint64_t stream;  ///< Stream number
+
+    private:
+        std::vector<std::uint64_t> scratch; ///< Positions reused by apply()
+};
+
+/**
+ * @class BinarySymmetricChannel
+ * @brief Flips every bit independently with probability p, using geometric skip sampling.
+ */
+class BinarySymmetricChannel : public Channel {
+
+    public:
+        /**
+         * @brief Constructor for BinarySymmetricChannel class.
+         * @param p Bit error rate in [0, 1].
+         * @param seed Seed of the error pattern.
+         * @param stream Independent stream number.
+         */
+        BinarySymmetricChannel(double p, std::uint64_t seed, std::uint64_t stream = 0);
+
+        void corrupt(std::uint64_t blocks, std::vector<std::uint64_t>& positions) override;
+
+    private:
+        double logKeep;     ///< log(1 - p)
+        std::uint64_t next; ///< Distance from the current position to the next flip
+};
+
+/**
+ * @class GilbertElliottChannel
+ * @brief Two-state Markov burst channel.
+ *
+ * The channel stays in its good or bad state for a geometric number of bits and flips bits
+ * with the state's error rate. Both the state changes and the flips are skip-sampled.
+ */
+class GilbertElliottChannel : public Channel {
+
+    public:
+        /**
+         * @brief Constructor for GilbertElliottChannel class; starts in the good state.
+         * @param pGoodToBad Per-bit probability of entering the bad state.
+         * @param pBadToGood Per-bit probability of leaving the bad state.
+         * @param pErrorGood Bit error rate in the good state.
+         * @param pErrorBad Bit error rate in the bad state.
+         * @param seed Seed of the error pattern.
+         * @param stream Independent stream number.
+         */
+        GilbertElliottChannel(double pGoodToBad, double pBadToGood, double pErrorGood, double pErrorBad,
+                              std::uint64_t seed, std::uint64_t stream = 0);
+
+        void corrupt(std::uint64_t blocks, std::vector<std::uint64_t>& positions) override;
+
+    private:
+        /**
+         * @brief Switches state and draws its duration and first flip.
+         * @param toBad The new state.
+         */
+        void enter(bool toBad);
+
+        double logStay[2];       ///< log(1 - leave probability) of the good and bad state
+        double logKeep[2];       ///< log(1 - error rate) of the good and bad state
+        bool bad;                ///< Current state
+        std::uint64_t stateLeft; ///< Bits left in the current state
+        std::uint64_t next;      ///< Distance from the current position to the next flip
+};
+
+/**
+ * @class ExactChannel
+ * @brief Flips exactly k distinct bits of every codeword.
+ *
+ * Flip j of codeword i is a pure function of (seed, stream + j, i); with k = 1
+ * this is the pattern ErrorEncode has always produced for a seed.
+ */
+class ExactChannel : public Channel {
+
+    public:
+        /**
+         * @brief Constructor for ExactChannel class.
+         * @param k Bits flipped per codeword (0 to 7).
+         * @param seed Seed of the error pattern.
+         * @param stream Independent stream number.
+         */
+        ExactChannel(unsigned k, std::uint64_t seed, std::uint64_t stream = 0);
+
+        void corrupt(std::uint64_t blocks, std::vector<std::uint64_t>& positions) override;
+
+    private:
+        unsigned k; ///< Bits flipped per codeword
+};
+
+#endif
@@ -0,0 +1,88 @@
+/* Colton Criswell and Zach Hamby
+ * Final Project - CS-300
+ */
+
+#ifndef HAMMING_CONTAINER_H
+#define HAMMING_CONTAINER_H
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+/*
+ * Packed container layout (.hmc):
+ *   ContainerHeader
+ *   chunk bodies, each plaintext byte stored as two bytes holding one 7-bit codeword each
+ *   ChunkIndexEntry for every chunk (the trailer index)
+ *   ContainerFooter
+ */
+
+static const char containerMagic[4] = {'H', 'M', 'C', '1'};       ///< Magic at the start of a container
+static const char containerIndexMagic[4] = {'H', 'M', 'C', 'I'};  ///< Magic at the end of a container
+static const std::uint32_t containerFlagCrc = 1;                   ///< Chunks carry a CRC32C of their plaintext
+static const std::size_t containerBytesPerByte = 2;                ///< Encoded bytes per plaintext byte
+
+/**
+ * @struct ContainerHeader
+ * @brief Fixed header at the start of a packed container.
+ */
+struct ContainerHeader {
+    char magic[4];           ///< containerMagic
+    std::uint32_t version;   ///< Format version (1)
+    std::uint32_t flags;     ///< containerFlag* bits
+    std::uint32_t chunkSize; ///< Plaintext bytes per chunk (the last chunk may be shorter)
+    std::uint64_t dataSize;  ///< Total plaintext bytes
+    std::uint64_t reserved;  ///< Zero
+};
+
+/**
+ * @struct ChunkIndexEntry
+ * @brief Trailer index entry describing one chunk.
+ */
+struct ChunkIndexEntry {
+    std::uint64_t offset;  ///< File offset of the chunk body
+    std::uint32_t length;  ///< Plaintext bytes in the chunk
+    std::uint32_t crc;     ///< CRC32C of the plaintext (0 without containerFlagCrc)
+};
+
+/**
+ * @struct ContainerFooter
+ * @brief Fixed footer at the end of a packed container, locating the trailer index.
+ */
+struct ContainerFooter {
+    std::uint64_t indexOffset; ///< File offset of the first ChunkIndexEntry
+    std::uint32_t chunkCount;  ///< Number of index entries
+    char magic[4];             ///< containerIndexMagic
+};
+
+/**
+ * @brief Checks whether a file starts with the packed container magic.
+ * @param file The name of the file to check.
+ * @return True if the file is a packed container.
+ */
+bool isContainer(const std::string& file);
+
+/**
+ * @brief Reads the header and trailer index of an open container.
+ * @param fd Open file descriptor of the container.
+ * @param header Receives the container header.
+ * @param index Receives one entry per chunk.
+ * @return False if the container is truncated or malformed (including a zero chunk size, a chunk
+ *         other than the last that is not chunkSize bytes long, or chunks not adding up to dataSize).
+ */
+bool readContainerIndex(int fd, ContainerHeader& header, std::vector<ChunkIndexEntry>& index);
+
+/**
+ * @brief Computes a CRC32C (Castagnoli) checksum.
+ *
+ * Uses the SSE4.2 crc32 instruction when the CPU has it, with three interleaved streams
+ * for large buffers, and a lookup table otherwise.
+ * @param data The bytes to checksum.
+ * @param length The number of bytes.
+ * @param crc A previous CRC32C to continue from (0 to start).
+ * @return The updated CRC32C.
+ */
+std::uint32_t crc32c(const void* data, std::size_t length, std::uint32_t crc = 0);
+
+#endif
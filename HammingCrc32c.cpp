@@ -0,0 +1,121 @@
+// CRC32C (Castagnoli) checksum used to catch Hamming miscorrections in packed containers
+// Hardware path: SSE4.2 crc32 instruction, three independent streams per block so the
+// 3-cycle instruction latency is hidden, then the streams are merged with a GF(2) multiply
+// Software path: byte-at-a-time lookup table
+
+#include <cstdint>
+#include <cstring>
+#include "HammingContainer.h"
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <nmmintrin.h>
+#define HAMMING_HAVE_SSE42_PATH 1
+#endif
+
+static const std::uint32_t crcPoly = 0x82F63B78;      //Reflected Castagnoli polynomial
+static const std::size_t crcLaneBytes = 8192;         //Bytes per interleaved stream
+
+//Lookup table for the software path
+static std::uint32_t crcTable[256];
+
+static bool buildCrcTable() {
+    for (std::uint32_t i = 0; i < 256; ++i) {
+        std::uint32_t c = i;
+        for (int k = 0; k < 8; ++k) c = (c & 1) ? (c >> 1) ^ crcPoly : c >> 1;
+        crcTable[i] = c;
+    }
+    return true;
+}
+static const bool crcTableReady = buildCrcTable();
+
+//Multiply two polynomials modulo the CRC polynomial (reflected bit order)
+static std::uint32_t multModP(std::uint32_t a, std::uint32_t b) {
+    std::uint32_t m = 1u << 31, p = 0;
+    for (;;) {
+        if (a & m) {
+            p ^= b;
+            if ((a & (m - 1)) == 0) break;
+        }
+        m >>= 1;
+        b = (b & 1) ? (b >> 1) ^ crcPoly : b >> 1;
+    }
+    return p;
+}
+
+//x^(8 * bytes) modulo the CRC polynomial; multiplying by it appends that many zero bytes
+static std::uint32_t zeroBytesOperator(std::size_t bytes) {
+    std::uint32_t result = 1u << 31;  //x^0
+    std::uint32_t power = 1u << 23;   //x^8
+    while (bytes) {
+        if (bytes & 1) result = multModP(result, power);
+        power = multModP(power, power);
+        bytes >>= 1;
+    }
+    return result;
+}
+
+//Raw (no pre/post inversion) CRC update, software path
+static std::uint32_t crcSoftware(std::uint32_t crc, const unsigned char* p, std::size_t n) {
+    (void)crcTableReady;
+    while (n--) crc = crcTable[(crc ^ *p++) & 0xFF] ^ (crc >> 8);
+    return crc;
+}
+
+#ifdef HAMMING_HAVE_SSE42_PATH
+__attribute__((target("sse4.2")))
+static std::uint32_t crcHardwareSerial(std::uint32_t crc, const unsigned char* p, std::size_t n) {
+    std::uint64_t c = crc;
+    while (n >= 8) {
+        std::uint64_t word;
+        std::memcpy(&word, p, 8);
+        c = _mm_crc32_u64(c, word);
+        p += 8;
+        n -= 8;
+    }
+    std::uint32_t c32 = static_cast<std::uint32_t>(c);
+    while (n--) c32 = _mm_crc32_u8(c32, *p++);
+    return c32;
+}
+
+//Raw CRC update, hardware path
+__attribute__((target("sse4.2")))
+static std::uint32_t crcHardware(std::uint32_t crc, const unsigned char* p, std::size_t n) {
+    static const std::uint32_t laneShift = zeroBytesOperator(crcLaneBytes);
+
+    while (n >= 3 * crcLaneBytes) {
+        std::uint64_t a = crc, b = 0, c = 0;
+        const unsigned char* pa = p;
+        const unsigned char* pb = p + crcLaneBytes;
+        const unsigned char* pc = p + 2 * crcLaneBytes;
+        for (std::size_t i = 0; i < crcLaneBytes; i += 8) {
+            std::uint64_t wa, wb, wc;
+            std::memcpy(&wa, pa + i, 8);
+            std::memcpy(&wb, pb + i, 8);
+            std::memcpy(&wc, pc + i, 8);
+            a = _mm_crc32_u64(a, wa);
+            b = _mm_crc32_u64(b, wb);
+            c = _mm_crc32_u64(c, wc);
+        }
+        //crc(A|B|C) = shift(shift(crcA) ^ crcB) ^ crcC
+        std::uint32_t ab = multModP(static_cast<std::uint32_t>(a), laneShift) ^ static_cast<std::uint32_t>(b);
+        crc = multModP(ab, laneShift) ^ static_cast<std::uint32_t>(c);
+        p += 3 * crcLaneBytes;
+        n -= 3 * crcLaneBytes;
+    }
+    return crcHardwareSerial(crc, p, n);
+}
+
+static bool cpuHasSse42() {
+    static const bool supported = __builtin_cpu_supports("sse4.2");
+    return supported;
+}
+#endif
+
+std::uint32_t crc32c(const void* data, std::size_t length, std::uint32_t crc) {
+    const unsigned char* p = static_cast<const unsigned char*>(data);
+    crc = ~crc;
+#ifdef HAMMING_HAVE_SSE42_PATH
+    if (cpuHasSse42()) return ~crcHardware(crc, p, length);
+#endif
+    return ~crcSoftware(crc, p, length);
+}
@@ -0,0 +1,426 @@
+// Local codec daemon over a Unix domain socket
+// One poll() loop serves all clients: each pass reads a bounded amount from every readable socket,
+// codes the inline requests of all clients as one batch, then answers each client with a single
+// write of all its responses. Path requests run the parallel encoder/decoder and scrubber on a
+// pool that lives as long as the daemon and report back through an eventfd the loop polls
+
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+#include <algorithm>
+#include <cerrno>
+#include <csignal>
+#include <cstring>
+#include <fcntl.h>
+#include <poll.h>
+#include <unistd.h>
+#include <sys/eventfd.h>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/un.h>
+#include "HammingDaemon.h"
+#include "HammingLatency.h"
+#include "ThreadPool.h"
+
+namespace {
+    volatile std::sig_atomic_t stopRequested = 0;
+
+    void requestStop(int) {
+        stopRequested = 1;
+    }
+
+    //Appends a response header and reserves room for its payload; returns the payload offset
+    std::size_t beginResponse(std::vector<char>& out, std::uint32_t id, std::int32_t status, std::size_t maxLength) {
+        std::size_t at = out.size();
+        DaemonResponse response = {id, status, 0};
+        out.resize(at + sizeof(response) + maxLength);
+        std::memcpy(out.data() + at, &response, sizeof(response));
+        return at + sizeof(response);
+    }
+
+    //Fixes the payload length once it is known and drops the unused reservation
+    void endResponse(std::vector<char>& out, std::size_t payloadAt, std::size_t length) {
+        DaemonResponse response;
+        std::memcpy(&response, out.data() + payloadAt - sizeof(response), sizeof(response));
+        response.length = static_cast<std::uint32_t>(length);
+        std::memcpy(out.data() + payloadAt - sizeof(response), &response, sizeof(response));
+        out.resize(payloadAt + length);
+    }
+
+    void textResponse(std::vector<char>& out, std::uint32_t id, std::int32_t status, const std::string& text) {
+        std::size_t at = beginResponse(out, id, status, text.size());
+        std::memcpy(out.data() + at, text.data(), text.size());
+        endResponse(out, at, text.size());
+    }
+
+    bool fileExists(const std::string& path) {
+        struct stat st;
+        return stat(path.c_str(), &st) == 0;
+    }
+}
+
+
+//Daemon class constructor
+Daemon::Daemon(std::string socketPath, unsigned threads) : Hamming(socketPath), threads(ThreadPool::resolveThreads(threads)) {
+    processFile();
+}
+Daemon::~Daemon() {}
+
+
+void Daemon::processFile() {
+    int listenFd = socket(AF_UNIX, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+    sockaddr_un address = {};
+    address.sun_family = AF_UNIX;
+    if (listenFd < 0 || fileName.size() >= sizeof(address.sun_path)) {
+        std::cerr << "Error creating socket: " << fileName << std::endl;
+        if (listenFd >= 0) close(listenFd);
+        return;
+    }
+    std::memcpy(address.sun_path, fileName.c_str(), fileName.size() + 1);
+    unlink(fileName.c_str());
+    if (bind(listenFd, reinterpret_cast<sockaddr*>(&address), sizeof(address)) != 0 || listen(listenFd, 128) != 0) {
+        std::cerr << "Error listening on socket: " << fileName << std::endl;
+        close(listenFd);
+        return;
+    }
+    wakeFd = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+    if (wakeFd < 0) {
+        std::cerr << "Error creating the daemon's eventfd." << std::endl;
+        close(listenFd);
+        unlink(fileName.c_str());
+        return;
+    }
+
+    struct sigaction action = {};
+    action.sa_handler = requestStop;
+    sigaction(SIGINT, &action, nullptr);
+    sigaction(SIGTERM, &action, nullptr);
+    signal(SIGPIPE, SIG_IGN);
+
+    pool = std::make_unique<ThreadPool>(threads);
+    std::vector<std::unique_ptr<Connection>> connections;
+    std::vector<pollfd> fds;
+    std::vector<InlineJob> batch;
+    std::uint64_t nextConnection = 1;
+    std::cout << "Daemon listening on " << fileName << ".\n" << std::flush;
+
+    while (!stopRequested) {
+        //A client is read only while it has room for a whole request and is taking its responses.
+        //One that hung up with nothing left to send is left out (poll skips a negative fd), since
+        //its POLLHUP would end every poll at once; its running files still wake the loop through wakeFd
+        fds.clear();
+        fds.push_back(pollfd{listenFd, POLLIN, 0});
+        fds.push_back(pollfd{wakeFd, POLLIN, 0});
+        for (const auto& connection : connections) {
+            bool room = connection->in.size() < sizeof(DaemonRequest) + daemonMaxPayload
+                     && connection->out.size() - connection->sent < maxPendingOutput;
+            short events = connection->closing || !room ? 0 : POLLIN;
+            if (connection->sent < connection->out.size()) events |= POLLOUT;
+            fds.push_back(pollfd{connection->closing && events == 0 ? -1 : connection->fd, events, 0});
+        }
+        if (poll(fds.data(), fds.size(), -1) < 0) {
+            if (errno == EINTR) continue;
+            std::cerr << "Error: poll() failed in the daemon." << std::endl;
+            break;
+        }
+
+        for (std::size_t i = 0; i < connections.size(); ++i) {
+            short revents = fds[i + 2].revents;
+            if (fds[i + 2].events & POLLIN) {
+                if (revents & (POLLIN | POLLHUP | POLLERR)) readRequests(*connections[i]);
+            } else if (revents & (POLLHUP | POLLERR)) {
+                connections[i]->closing = true;
+            }
+        }
+
+        if (fds[0].revents & POLLIN) {
+            for (int fd; (fd = accept4(listenFd, nullptr, nullptr, SOCK_NONBLOCK | SOCK_CLOEXEC)) >= 0;) {
+                connections.push_back(std::make_unique<Connection>());
+                connections.back()->fd = fd;
+                connections.back()->id = nextConnection++;
+            }
+        }
+
+        //Responses of finished file requests join their client's output (dropped if it is gone)
+        if (fds[1].revents & POLLIN) {
+            std::uint64_t signals;
+            while (read(wakeFd, &signals, sizeof(signals)) < 0 && errno == EINTR) {}
+            std::vector<Finished> ready;
+            {
+                std::lock_guard<std::mutex> lock(finishedMutex);
+                ready.swap(finished);
+            }
+            for (Finished& done : ready) {
+                for (auto& connection : connections) {
+                    if (connection->id != done.connection) continue;
+                    connection->out.insert(connection->out.end(), done.response.begin(), done.response.end());
+                    --connection->running;
+                    break;
+                }
+            }
+        }
+
+        //Gather the inline requests of every client, code them as one batch, then answer each client with one write
+        batch.clear();
+        for (auto& connection : connections) handleRequests(*connection, batch);
+        runBatch(batch);
+        finishBatch(batch, connections);
+
+        for (auto& connection : connections) {
+            if (connection->sent < connection->out.size()) {
+                LatencyScope latency(LatencyOp::Write);
+                while (connection->sent < connection->out.size()) {
+                    ssize_t n = write(connection->fd, connection->out.data() + connection->sent, connection->out.size() - connection->sent);
+                    if (n > 0) {
+                        connection->sent += static_cast<std::size_t>(n);
+                        continue;
+                    }
+                    if (n < 0 && errno == EINTR) continue;
+                    if (n < 0 && errno != EAGAIN) {
+                        connection->closing = true;
+                        connection->sent = connection->out.size();
+                    }
+                    break;
+                }
+            }
+            if (connection->sent == connection->out.size()) {
+                connection->out.clear();
+                connection->sent = 0;
+            }
+        }
+
+        //Drop clients that hung up once their responses are out and none of their files are running
+        for (std::size_t i = 0; i < connections.size();) {
+            const Connection& connection = *connections[i];
+            if (connection.closing && connection.out.empty() && connection.running == 0) {
+                close(connection.fd);
+                connections.erase(connections.begin() + static_cast<std::ptrdiff_t>(i));
+            } else {
+                ++i;
+            }
+        }
+    }
+
+    //Running file requests finish first; their responses go nowhere
+    pool.reset();
+    for (const auto& connection : connections) close(connection->fd);
+    close(wakeFd);
+    close(listenFd);
+    unlink(fileName.c_str());
+    std::cout << "Daemon stopped.\n";
+}
+
+
+void Daemon::readRequests(Connection& connection) {
+    LatencyScope latency(LatencyOp::Read);
+    std::size_t limit = sizeof(DaemonRequest) + daemonMaxPayload;
+    std::size_t budget = readBudget;
+    while (budget > 0 && connection.in.size() < limit) {
+        std::size_t at = connection.in.size();
+        std::size_t want = std::min<std::size_t>({64 << 10, budget, limit - at});
+        connection.in.resize(at + want);
+        ssize_t n = read(connection.fd, connection.in.data() + at, want);
+        connection.in.resize(at + static_cast<std::size_t>(n > 0 ? n : 0));
+        if (n > 0) {
+            budget -= static_cast<std::size_t>(n);
+            continue;
+        }
+        if (n < 0 && errno == EINTR) continue;
+        if (n == 0 || errno != EAGAIN) connection.closing = true;
+        break;
+    }
+}
+
+void Daemon::handleRequests(Connection& connection, std::vector<InlineJob>& batch) {
+    std::size_t pos = 0;
+    while (connection.in.size() - pos >= sizeof(DaemonRequest)) {
+        DaemonRequest request;
+        std::memcpy(&request, connection.in.data() + pos, sizeof(request));
+        if (request.magic != daemonMagic || request.length > daemonMaxPayload) {
+            textResponse(connection.out, request.id, -1, "malformed request");
+            connection.closing = true;
+            pos = connection.in.size();
+            break;
+        }
+        if (connection.in.size() - pos - sizeof(request) < request.length) break;
+
+        const char* payload = connection.in.data() + pos + sizeof(request);
+        pos += sizeof(request) + request.length;
+        DaemonOp op = static_cast<DaemonOp>(request.op);
+
+        //Latency histograms of this daemon, whatever the payload
+        if (op == DaemonOp::Latency) {
+            std::ostringstream json;
+            Latency::writeJson(json);
+            textResponse(connection.out, request.id, Latency::enabled() ? 0 : 1, Latency::enabled() ? json.str() : "latency recording is off");
+            continue;
+        }
+
+        //Inline data: reserve the response now, code it with the rest of the batch. An encode
+        //writes 15 bytes per non-newline byte, a decode at most one byte per line
+        if (request.payload == static_cast<std::uint8_t>(DaemonPayload::Inline)) {
+            if (op != DaemonOp::Encode && op != DaemonOp::Decode) {
+                textResponse(connection.out, request.id, 2, "operation needs a path");
+                continue;
+            }
+            std::size_t newlines = static_cast<std::size_t>(std::count(payload, payload + request.length, '\n'));
+            std::size_t reserve = op == DaemonOp::Encode ? (request.length - newlines) * 15 : newlines + 1;
+            std::size_t at = beginResponse(connection.out, request.id, 0, reserve);
+            batch.push_back(InlineJob{&connection, op, payload, request.length, at, reserve});
+            continue;
+        }
+
+        std::string path(payload, request.length);
+        if (!fileExists(path)) {
+            textResponse(connection.out, request.id, 1, "cannot open " + path);
+            continue;
+        }
+        ++connection.running;
+        pool->submit([this, id = connection.id, request, path] { runFileRequest(id, request, path); });
+    }
+    connection.handled = pos;
+}
+
+//Jobs are cut into slices of about equal bytes, one per worker; the poll thread helps with them
+void Daemon::runBatch(std::vector<InlineJob>& batch) {
+    if (batch.empty()) return;
+    std::size_t total = 0;
+    for (const InlineJob& job : batch) total += job.length;
+
+    auto code = [this, &batch](std::size_t first, std::size_t last) {
+        for (std::size_t k = first; k < last; ++k) {
+            InlineJob& job = batch[k];
+            LatencyScope latency(LatencyOp::Request);
+            char* out = job.connection->out.data() + job.at;
+            if (job.op == DaemonOp::Encode) {
+                job.produced = encodeToText(job.payload, job.length, out);
+            } else {
+                DecodeStats stats;
+                job.produced = decodeFromText(job.payload, job.length, out, stats);
+            }
+        }
+    };
+    if (total < parallelBatchBytes || pool->size() < 2 || batch.size() < 2) {
+        code(0, batch.size());
+        return;
+    }
+
+    ThreadPool::Group group;
+    std::size_t slice = total / pool->size() + 1;
+    for (std::size_t first = 0; first < batch.size();) {
+        std::size_t last = first, bytes = 0;
+        while (last < batch.size() && (last == first || bytes + batch[last].length <= slice)) bytes += batch[last++].length;
+        pool->submit(group, [&code, first, last] { code(first, last); });
+        first = last;
+    }
+    pool->wait(group);
+}
+
+void Daemon::finishBatch(const std::vector<InlineJob>& batch, std::vector<std::unique_ptr<Connection>>& connections) {
+    //Walking each client's jobs in order, every byte after a job's unused reservation moves down
+    //by the space freed so far
+    for (auto& connection : connections) {
+        std::vector<char>& out = connection->out;
+        std::size_t shift = 0, copied = 0;  //copied: original offset up to which bytes are in place
+        for (const InlineJob& job : batch) {
+            if (job.connection != connection.get()) continue;
+            DaemonResponse response;
+            std::memcpy(&response, out.data() + job.at - sizeof(response), sizeof(response));
+            response.length = static_cast<std::uint32_t>(job.produced);
+            std::memcpy(out.data() + job.at - sizeof(response), &response, sizeof(response));
+
+            if (shift) std::memmove(out.data() + copied - shift, out.data() + copied, job.at + job.produced - copied);
+            copied = job.at + job.reserved;
+            shift += job.reserved - job.produced;
+        }
+        if (shift) {
+            std::memmove(out.data() + copied - shift, out.data() + copied, out.size() - copied);
+            out.resize(out.size() - shift);
+        }
+
+        connection->in.erase(connection->in.begin(), connection->in.begin() + static_cast<std::ptrdiff_t>(connection->handled));
+        connection->handled = 0;
+    }
+}
+
+void Daemon::runFileRequest(std::uint64_t connection, DaemonRequest request, const std::string& path) {
+    LatencyScope latency(LatencyOp::Request);
+    DaemonOp op = static_cast<DaemonOp>(request.op);
+    Finished done{connection, {}};
+    if (op == DaemonOp::Encode) {
+        ParallelEncode parallelEncode(path, *pool);
+        textResponse(done.response, request.id, 0, path.substr(0, path.find_last_of('.')) + "_out.txt");
+    } else if (op == DaemonOp::Decode) {
+        ParallelDecode parallelDecode(path, *pool);
+        const DecodeStats& stats = parallelDecode.getStats();
+        textResponse(done.response, request.id, 0, path.substr(0, path.find_last_of('.')) + "_decoded.txt: " + std::to_string(stats.blocks)
+                     + " blocks, " + std::to_string(stats.corrected) + " corrected, " + std::to_string(stats.malformed) + " malformed");
+    } else if (op == DaemonOp::Scrub) {
+        Scrub scrub(path);
+        const Scrub::Summary& summary = scrub.getSummary();
+        textResponse(done.response, request.id, summary.failedChunks ? 2 : 0, std::to_string(summary.correctedBlocks) + " blocks corrected, "
+                     + std::to_string(summary.rewrittenBytes) + " bytes rewritten, " + std::to_string(summary.failedChunks) + " chunks failed");
+    } else {
+        textResponse(done.response, request.id, 2, "unknown operation");
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(finishedMutex);
+        finished.push_back(std::move(done));
+    }
+    std::uint64_t one = 1;
+    while (write(wakeFd, &one, sizeof(one)) < 0 && errno == EINTR) {}
+}
+
+
+//DaemonClient class constructor
+DaemonClient::DaemonClient(const std::string& socketPath) : fd(-1), nextId(1) {
+    sockaddr_un address = {};
+    address.sun_family = AF_UNIX;
+    if (socketPath.size() >= sizeof(address.sun_path)) return;
+    std::memcpy(address.sun_path, socketPath.c_str(), socketPath.size() + 1);
+
+    fd = socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0);
+    if (fd >= 0 && connect(fd, reinterpret_cast<sockaddr*>(&address), sizeof(address)) != 0) {
+        close(fd);
+        fd = -1;
+    }
+}
+
+DaemonClient::~DaemonClient() {
+    if (fd >= 0) close(fd);
+}
+
+bool DaemonClient::isConnected() const {
+    return fd >= 0;
+}
+
+int DaemonClient::call(DaemonOp op, DaemonPayload payloadKind, const std::string& payload, std::string& result) {
+    if (fd < 0 || payload.size() > daemonMaxPayload) return -1;
+
+    DaemonRequest request = {daemonMagic, static_cast<std::uint8_t>(op), static_cast<std::uint8_t>(payloadKind), 0,
+                             nextId++, static_cast<std::uint32_t>(payload.size())};
+    std::string message(reinterpret_cast<const char*>(&request), sizeof(request));
+    message += payload;
+    for (std::size_t done = 0; done < message.size();) {
+        ssize_t n = write(fd, message.data() + done, message.size() - done);
+        if (n <= 0) return -1;
+        done += static_cast<std::size_t>(n);
+    }
+
+    DaemonResponse response;
+    auto readFully = [this](void* buffer, std::size_t length) {
+        char* p = static_cast<char*>(buffer);
+        for (std::size_t done = 0; done < length;) {
+            ssize_t n = read(fd, p + done, length - done);
+            if (n <= 0) return false;
+            done += static_cast<std::size_t>(n);
+        }
+        return true;
+    };
+    if (!readFully(&response, sizeof(response))) return -1;
+    result.resize(response.length);
+    if (!readFully(result.data(), result.size())) return -1;
+    return response.status;
+}
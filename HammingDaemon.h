@@ -0,0 +1,220 @@
+/* Colton Criswell and Zach Hamby
+ * Final Project - CS-300
+ */
+
+#ifndef HAMMING_DAEMON_H
+#define HAMMING_DAEMON_H
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+#include "Hamming.h"
+
+/*
+ * Wire protocol (native byte order), one or more requests per connection:
+ *   DaemonRequest header, then `length` payload bytes (a path or the inline data)
+ *   DaemonResponse header, then `length` payload bytes (the inline result or a summary line)
+ */
+
+static const std::uint32_t daemonMagic = 0x51444D48;          ///< "HMDQ"
+static const std::uint32_t daemonMaxPayload = 64u << 20;      ///< Largest accepted payload
+
+/**
+ * @brief Operations understood by the daemon.
+ */
+enum class DaemonOp : std::uint8_t { Encode = 1, Decode = 2, Scrub = 3, Latency = 4 };
+
+/**
+ * @brief Payload kinds of a request.
+ */
+enum class DaemonPayload : std::uint8_t { Inline = 0, Path = 1 };
+
+/**
+ * @struct DaemonRequest
+ * @brief Header of one request.
+ */
+struct DaemonRequest {
+    std::uint32_t magic;    ///< daemonMagic
+    std::uint8_t op;        ///< DaemonOp
+    std::uint8_t payload;   ///< DaemonPayload
+    std::uint16_t reserved; ///< Zero
+    std::uint32_t id;       ///< Echoed in the response
+    std::uint32_t length;   ///< Payload bytes that follow
+};
+
+/**
+ * @struct DaemonResponse
+ * @brief Header of one response.
+ */
+struct DaemonResponse {
+    std::uint32_t id;     ///< Id of the request
+    std::int32_t status;  ///< 0 on success
+    std::uint32_t length; ///< Payload bytes that follow
+};
+
+class ThreadPool;
+
+/**
+ * @class Daemon
+ * @brief Derived class serving codec requests over a Unix domain socket.
+ *
+ * One poll() loop serves every connection. Each pass reads what the clients have sent (a bounded
+ * amount per client), gathers the complete inline requests of all clients into one batch that is
+ * coded in a single sweep (split across the pool when it is large), and answers each connection
+ * with a single write, so many small requests cost a handful of system calls. Requests naming a
+ * file run on the pool and wake the loop through an eventfd when done, so a large file never
+ * holds up other clients; their responses can arrive after those of later inline requests on
+ * the same connection, so clients match responses by id. The codec tables are built once.
+ */
+class Daemon : public Hamming {
+
+    public:
+        static const std::size_t readBudget = 1 << 20;           ///< Bytes read from one client per pass
+        static const std::size_t maxPendingOutput = 16 << 20;    ///< Unsent response bytes above which a client is not read
+        static const std::size_t parallelBatchBytes = 256 << 10; ///< Inline batch size from which the pool codes it
+
+        /**
+         * @brief Constructor for Daemon class; serves until SIGINT or SIGTERM.
+         * @param socketPath Path of the Unix domain socket to listen on.
+         * @param threads Worker threads for file requests and large inline batches (0 = one per core).
+         */
+        Daemon(std::string socketPath, unsigned threads = 0);
+
+        /**
+         * @brief Destructor for Daemon class.
+         */
+        ~Daemon();
+
+    private:
+        /**
+         * @struct Connection
+         * @brief Buffered state of one client.
+         */
+        struct Connection {
+            int fd;                   ///< Client socket
+            std::uint64_t id = 0;     ///< Identifies the client to finished file requests
+            std::vector<char> in;     ///< Bytes received but not yet handled
+            std::size_t handled = 0;  ///< Bytes of in consumed by this pass's requests
+            std::vector<char> out;    ///< Responses not yet sent
+            std::size_t sent = 0;     ///< Bytes of out already sent
+            std::size_t running = 0;  ///< File requests still on the pool
+            bool closing = false;     ///< Close once out is drained and nothing is running
+        };
+
+        /**
+         * @struct InlineJob
+         * @brief One inline encode or decode of the current batch.
+         */
+        struct InlineJob {
+            Connection* connection;   ///< Client the response goes to
+            DaemonOp op;              ///< Encode or Decode
+            const char* payload;      ///< Request data, inside connection->in
+            std::size_t length;       ///< Request data bytes
+            std::size_t at;           ///< Offset of the response payload in connection->out
+            std::size_t reserved;     ///< Bytes reserved there (exact for encode, an upper bound for decode)
+            std::size_t produced = 0; ///< Bytes the codec wrote
+        };
+
+        /**
+         * @struct Finished
+         * @brief A file request's response, handed from a pool worker to the poll loop.
+         */
+        struct Finished {
+            std::uint64_t connection;     ///< Connection::id of the client
+            std::vector<char> response;   ///< Header and payload
+        };
+
+        /**
+         * @brief Accepts connections and serves requests.
+         */
+        void processFile() override;
+
+        /**
+         * @brief Reads what a client has sent, within the per-pass budget.
+         * @param connection The client.
+         */
+        void readRequests(Connection& connection);
+
+        /**
+         * @brief Answers or queues every complete request buffered on a connection.
+         * @param connection The client.
+         * @param batch Receives the inline encode and decode requests; their payloads stay in
+         *              connection.in until finishBatch().
+         */
+        void handleRequests(Connection& connection, std::vector<InlineJob>& batch);
+
+        /**
+         * @brief Codes every inline request of the pass, on the pool if the batch is large.
+         * @param batch The requests gathered by handleRequests().
+         */
+        void runBatch(std::vector<InlineJob>& batch);
+
+        /**
+         * @brief Sets the response lengths of a coded batch, closes the gaps left by decode
+         *        reservations and drops the handled input.
+         * @param batch The coded requests, in the order they were gathered.
+         * @param connections Every client.
+         */
+        void finishBatch(const std::vector<InlineJob>& batch, std::vector<std::unique_ptr<Connection>>& connections);
+
+        /**
+         * @brief Runs a file request on the calling pool worker and hands its response to the poll loop.
+         * @param connection Connection::id of the client.
+         * @param request The request header.
+         * @param path The file named by the request.
+         */
+        void runFileRequest(std::uint64_t connection, DaemonRequest request, const std::string& path);
+
+        unsigned threads;                  ///< Worker threads for file requests and large batches
+        std::unique_ptr<ThreadPool> pool;  ///< Pool for file requests and large batches
+        int wakeFd = -1;                   ///< eventfd the pool signals when a file request finishes
+        std::mutex finishedMutex;          ///< Guards finished
+        std::vector<Finished> finished;    ///< File responses not yet queued on their connection
+};
+
+/**
+ * @class DaemonClient
+ * @brief Connection to a running Daemon.
+ */
+class DaemonClient {
+
+    public:
+        /**
+         * @brief Constructor for DaemonClient class.
+         * @param socketPath Path of the daemon's socket.
+         */
+        DaemonClient(const std::string& socketPath);
+
+        /**
+         * @brief Destructor for DaemonClient class; closes the connection.
+         */
+        ~DaemonClient();
+
+        DaemonClient(const DaemonClient&) = delete;
+        DaemonClient& operator=(const DaemonClient&) = delete;
+
+        /**
+         * @brief Checks whether the connection was established.
+         * @return True if connected.
+         */
+        bool isConnected() const;
+
+        /**
+         * @brief Sends one request and waits for its response.
+         * @param op The operation.
+         * @param payloadKind Whether payload is a path or inline data.
+         * @param payload The path or data.
+         * @param result Receives the response payload.
+         * @return The response status (non-zero on failure; -1 if the connection failed).
+         */
+        int call(DaemonOp op, DaemonPayload payloadKind, const std::string& payload, std::string& result);
+
+    private:
+        int fd;               ///< Connected socket, or -1
+        std::uint32_t nextId; ///< Id for the next request
+};
+
+#endif
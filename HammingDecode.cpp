@@ -1,25 +1,38 @@
 // Read each line of a binary text file by 7 bits (ints) at a time
 // Check the 7 bit's parity for errors; error correct as needed.
-// Error message if too many errors in a block
+// Corrections and malformed lines are counted in DecodeStats and reported once;
+// per-record tracing is opt-in through the verbosity level
 // output decoded message to created file
 
 #include <iostream>
 #include <fstream>
+#include <array>
 #include <vector>
 #include <string>
 #include <bitset>
 #include "Eigen/Dense"
 #include "Hamming.h"
+#include "HammingMetrics.h"
 
 
 //Constructor for Decode class
-Decode::Decode(std::string file) : Hamming(file) {
+Decode::Decode(std::string file, Verbosity verbosity) : Hamming(file), verbosity(verbosity) {
     processFile();
 }
+
+//Constructor for derived decoders that only need the correction helpers
+Decode::Decode(std::string file, bool process) : Hamming(file), verbosity(Verbosity::Summary) {
+    if (process) processFile();
+}
 Decode::~Decode() {}
 
 
+const DecodeStats& Decode::getStats() const {
+    return stats;
+}
+
 void Decode::processFile() {
+    stats = DecodeStats();
     std::ifstream inputFile(fileName, std::ios::in);
     if (!inputFile.is_open()) {
         std::cerr << "Error opening file: " << fileName << std::endl;
@@ -38,28 +51,30 @@ void Decode::processFile() {
     std::string line;
 
     while (std::getline(inputFile, line)) {
-        if (line.length() != 14) {
-            std::cerr << "Error: Expected 14 bits per line in the file. Line has " << line.length() << " bits." << std::endl;
+        if (line.length() != 14 || line.find_first_not_of("01") != std::string::npos) {
+            if (line.empty()) continue;
+            ++stats.malformed;
+            if (verbosity == Verbosity::Trace) std::cerr << "Skipped line of " << line.length() << " characters; expected 14 bits.\n";
             continue;
         }
 
-        //Ensure the pair is empty if any block is corrupted
-        auto [data1, data2] = parseAndCorrectBlock(line);
-        if (data1.size() == 0 || data2.size() == 0) continue;  // Skip corrupted blocks
+        std::size_t correctedBefore = stats.corrected;
+        auto [data1, data2] = parseAndCorrectBlock(line, stats);
+        Metrics::count(line.size() + 1, 1, 2, stats.corrected - correctedBefore);
 
         //If data is valid, decode the character
         char decodedChar = combineDataAndConvertToChar(data1, data2);
 
-        //Print binary and decoded character to the terminal
-        std::string binaryString = "";
-        for (int i = 0; i < 4; ++i) {
-            binaryString += std::to_string(data1(0, i)); 
+        //Per-record trace; newline rather than endl so the stream is not flushed for every character
+        if (verbosity == Verbosity::Trace) {
+            char binary[9];
+            for (int i = 0; i < 4; ++i) {
+                binary[i] = static_cast<char>('0' + data1(0, i));
+                binary[4 + i] = static_cast<char>('0' + data2(0, i));
+            }
+            binary[8] = '\0';
+            std::cout << "Binary: " << binary << " -> ASCII: " << decodedChar << '\n';
         }
-        for (int i = 0; i < 4; ++i) {
-            binaryString += std::to_string(data2(0, i)); 
-        }
-
-        std::cout << "Binary: " << binaryString << " -> ASCII: " << decodedChar << std::endl;
 
         //Write the decoded character to the output file (this is the only file written to)
         outFile << decodedChar;
@@ -67,20 +82,25 @@ void Decode::processFile() {
 
     outFile.close();
     inputFile.close();
-    std::cout << "Decoding complete. Output written to " << fileName.substr(0, fileName.find_last_of('.')) + "_decoded.txt" << ".\n";
+    if (verbosity != Verbosity::Quiet) {
+        std::cout << "Decoding complete. ";
+        stats.print(std::cout);
+        std::cout << " Output written to " << outFileName << ".\n";
+    }
 }
 
 
 
-//Parse a line of binary text into a vector of integers
-std::vector<int> Decode::parseLineToBits(const std::string& line) const {
-    std::vector<int> bits;
+//Parse a line of binary text into a fixed array; digits past the 14th are only counted
+std::size_t Decode::parseLineToBits(const std::string& line, std::array<int, 14>& bits) const {
+    std::size_t count = 0;
     for (char c : line) {
         if (c == '0' || c == '1') {
-            bits.push_back(c - '0');
+            if (count < bits.size()) bits[count] = c - '0';
+            ++count;
         }
     }
-    return bits;
+    return count;
 }
 
 //Extract the original 4-bit data from the corrected 7-bit block
@@ -108,17 +128,15 @@ int Decode::checkParity(const Eigen::Matrix<int, 1, 7>& block) const {
 
 
 //Helper function
-Eigen::Matrix<int, 1, 7> Decode::correctBlock(const Eigen::Matrix<int, 1, 7>& block) const {
+Eigen::Matrix<int, 1, 7> Decode::correctBlock(const Eigen::Matrix<int, 1, 7>& block, DecodeStats& stats) const {
     Eigen::Matrix<int, 1, 7> correctedBlock = block;
     int errorPosition = checkParity(block);
 
-    if (errorPosition > 0 && errorPosition <= 7) {
+    stats.record(static_cast<unsigned>(errorPosition));
+    if (errorPosition > 0) {
         //Correct the single-bit error
         correctedBlock(0, errorPosition - 1) ^= 1;
-    } else if (errorPosition > 7) {
-        //Log and skip blocks with multiple errors
-        std::cerr << "Multiple errors detected in block: " << block << std::endl;
-        return {};  //Return empty block
+        if (verbosity == Verbosity::Trace) std::cerr << "Corrected bit " << errorPosition << " of block " << block << '\n';
     }
 
     return correctedBlock;
@@ -135,11 +153,11 @@ char Decode::byteToChar(const Eigen::Matrix<int, 1, 8>& data) const {
 }
 
 //Helper to parse and correct blocks, returning two 4-bit data matrices
-std::pair<Eigen::Matrix<int, 1, 4>, Eigen::Matrix<int, 1, 4>> Decode::parseAndCorrectBlock(const std::string& line) const {
-    std::vector<int> bits = parseLineToBits(line); // Parse line into bits
-    if (bits.size() != 14) {
-        std::cerr << "Error: Expected 14 bits per line. Line has " << bits.size() << " bits." << std::endl;
-        return {}; //Return empty pair if invalid
+std::pair<Eigen::Matrix<int, 1, 4>, Eigen::Matrix<int, 1, 4>> Decode::parseAndCorrectBlock(const std::string& line, DecodeStats& stats) const {
+    std::array<int, 14> bits;
+    if (parseLineToBits(line, bits) != 14) {
+        ++stats.malformed;
+        return std::make_pair(Eigen::Matrix<int, 1, 4>::Zero(), Eigen::Matrix<int, 1, 4>::Zero());
     }
 
     //Split into two 7-bit blocks
@@ -148,12 +166,8 @@ std::pair<Eigen::Matrix<int, 1, 4>, Eigen::Matrix<int, 1, 4>> Decode::parseAndCo
     for (int i = 7; i < 14; ++i) secondBlock(0, i - 7) = bits[i];
 
     //Check and correct parity for each block
-    firstBlock = correctBlock(firstBlock);
-    secondBlock = correctBlock(secondBlock);
-
-    //If either block is empty (indicating multiple errors), return an empty pair
-    if (firstBlock.size() == 0) std::cerr << "Corrupted first block detected." << std::endl;
-    if (secondBlock.size() == 0) std::cerr << "Corrupted second block detected." << std::endl;
+    firstBlock = correctBlock(firstBlock, stats);
+    secondBlock = correctBlock(secondBlock, stats);
 
     //Extract data bits
     Eigen::Matrix<int, 1, 4> data1 = extractData(firstBlock);
@@ -4,11 +4,15 @@
 #include <iostream>
 #include "Eigen/Dense"
 #include "Hamming.h"
+#include "HammingMetrics.h"
 
 
 //Encode class constructor
-Encode::Encode(std::string file) : Hamming(file) {
-    processFile();
+Encode::Encode(std::string file) : Encode(file, true) {}
+
+//Constructor for derived encoders that produce their codewords another way
+Encode::Encode(std::string file, bool process) : Hamming(file) {
+    if (process) processFile();
 }
 Encode::~Encode(){}
 
@@ -40,7 +44,12 @@ void Encode::processFile() {
         return;
     }
 
+    //Two codewords per character; reserving them up front keeps push_back from reallocating
+    encodedMessages.reserve(encodedMessages.size() + 2 * originalMessage.size());
+
+    //No line is longer than the message, so reading lines never regrows the buffer
     std::string line;
+    line.reserve(originalMessage.size());
     while (std::getline(inputFile, line)) {
         if (line.empty()) continue;
 
@@ -70,6 +79,7 @@ void Encode::processFile() {
             encodedMessages.push_back(encodedMsg1);
             encodedMessages.push_back(encodedMsg2);
         }
+        Metrics::count(line.size() + 1, line.size() * 15, line.size() * 2);
     }
 
     inputFile.close();
@@ -123,8 +133,16 @@ std::string Encode::getOriginalMessage(const std::string& fileName) const {
         return "";
     }
 
+    //The message and any line fit in the file's size; reserving it keeps both from regrowing
     std::string originalMessage;
     std::string line;
+    inputFile.seekg(0, std::ios::end);
+    std::streamoff size = inputFile.tellg();
+    inputFile.seekg(0, std::ios::beg);
+    if (size > 0) {
+        originalMessage.reserve(static_cast<std::size_t>(size));
+        line.reserve(static_cast<std::size_t>(size));
+    }
     while (std::getline(inputFile, line)) {
         if (!line.empty()) {
             originalMessage += line;  //Append each character (line) to the message
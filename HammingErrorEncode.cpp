@@ -1,83 +1,314 @@
 // Inherit from Hamming Encode
 // Encodes text from file to hamming code binary with errors
-// Include errorEncodeStatic, which manipulates a specific bit
-// Include errorEncodeRand, which manipulates rand bit per hamming code
+// Clean codewords come from a plain file, an encoded file, or an Encode object that already ran
+// They pass through a channel model or a saved error overlay chunk by chunk and are written out in one streaming pass
+// Recorded fault maps are merged into a block copy of the stored file (text or packed) instead
 // All output pushed to output file
 
 #include <string>
 #include <iostream>
 #include <fstream>
-#include <random>
-#include <cstdlib>
-#include <ctime>
+#include <vector>
+#include <algorithm>
+#include <cstring>
+#include <memory>
+#include <fcntl.h>
+#include <unistd.h>
 #include "Hamming.h"
+#include "HammingChannel.h"
+#include "HammingErrorMap.h"
+#include "HammingContainer.h"
+#include "HammingLatency.h"
+#include "HammingMetrics.h"
+#include "HammingProfile.h"
+#include "HammingTrace.h"
 
+namespace {
+    const std::size_t chunkBlocks = 1 << 16;  //Codewords per chunk (even, so records never split)
+    const std::size_t copyBlock = 1 << 20;    //Bytes per read/write of a fault replay
+
+    bool writeAll(int fd, const char* data, std::size_t length) {
+        while (length > 0) {
+            ssize_t n = write(fd, data, length);
+            if (n <= 0) return false;
+            data += n;
+            length -= static_cast<std::size_t>(n);
+        }
+        return true;
+    }
+}
 
-ErrorEncode::ErrorEncode(std::string file) : Encode(file) {
 
-    encodeFile();
+ErrorEncode::ErrorEncode(std::string file, std::uint64_t seed, std::string channel, Input input)
+    : Encode(file, false), seed(seed), channel(channel), input(input), clean(nullptr), errors(nullptr), faults(nullptr) {
+    processFile();
+}
+
+ErrorEncode::ErrorEncode(const Encode& clean, std::uint64_t seed, std::string channel)
+    : Encode(clean.fileName, false), seed(seed), channel(channel), input(Input::Plain), clean(&clean), errors(nullptr), faults(nullptr) {
+    processFile();
+}
+
+ErrorEncode::ErrorEncode(std::string file, const ErrorMap& errors, Input input)
+    : Encode(file, false), seed(0), input(input), clean(nullptr), errors(&errors), faults(nullptr) {
+    processFile();
+}
+ErrorEncode::ErrorEncode(std::string file, FaultMapReader& faults)
+    : Encode(file, false), seed(0), input(Input::Encoded), clean(nullptr), errors(nullptr), faults(&faults) {
+    processFile();
 }
 ErrorEncode::~ErrorEncode(){}
 
-  
-void ErrorEncode::encodeFile() {
-    std::cout << "encodeFile() is called!" << std::endl;
 
-    //Check if encodedMessages is already populated
-    if (this->getEncodedMessages().empty()) {
-        // Call base class processFile (encodes the original message)
-        Encode::processFile();
-    } else {
-        std::cout << "Skipping redundant encoding process.\n";
+void ErrorEncode::processFile() {
+    if (faults) replayFaults();
+    else encodeFile();
+}
+
+void ErrorEncode::encodeFile() {
+    std::unique_ptr<Channel> model;
+    if (!errors) {
+        model = Channel::create(channel, seed);
+        if (!model) return;
     }
 
-    //introduce errors into the encoded messages
-    errorEncodeRand();  
+    //test1.txt and test1_out.txt both become test1_e_out.txt
+    std::string stem = fileName.substr(0, fileName.find_last_of('.'));
+    if (input == Input::Encoded && stem.size() >= 4 && stem.compare(stem.size() - 4, 4, "_out") == 0) stem.resize(stem.size() - 4);
+    std::string outputFileName = stem + "_e_out.txt";
 
-    // Check if hammingCodeWithErrors is populated
-    if (hammingCodeWithErrors.empty()) {
-        std::cerr << "Error: hammingCodeWithErrors is empty. No errors introduced." << std::endl;
-        return;
+    std::ifstream inputFile;
+    if (!clean) {
+        inputFile.open(fileName, std::ios::in | std::ios::binary);
+        if (!inputFile.is_open()) {
+            std::cerr << "Error opening file: " << fileName << std::endl;
+            return;
+        }
     }
-
-    //Output to file
-    std::string outputFileName = fileName.substr(0, fileName.find_last_of('.')) + "_e_out.txt";
-    std::ofstream outputFile(outputFileName, std::ios::out | std::ios::trunc);
+    std::ofstream outputFile(outputFileName, std::ios::out | std::ios::trunc | std::ios::binary);
     if (!outputFile.is_open()) {
         std::cerr << "Error creating output file" << std::endl;
         return;
     }
 
-    //Write the modified Hamming codes to the output file
-    for (size_t i = 0; i < hammingCodeWithErrors.size(); i += 2) {
-        if (i + 1 < hammingCodeWithErrors.size()) {
-            const auto& code1 = hammingCodeWithErrors[i];
-            const auto& code2 = hammingCodeWithErrors[i + 1];
+    std::vector<unsigned char> codewords(chunkBlocks);
+    std::vector<char> text(chunkBlocks / 2 * 15);
+    std::vector<char> plain(chunkBlocks / 2);
+    std::size_t blocks = 0, flipped = 0, cursor = 0;
+    std::size_t consumed = 0;  //Input bytes behind the pending chunk
+    std::size_t chunk = 0;     //Sequence number of the pending chunk
+
+    //Corrupt a chunk of clean codewords and write them as records of two
+    auto flush = [&](std::size_t count) {
+        {
+            HAMMING_PROFILE_SCOPE(Inject);
+            TraceScope trace("inject", chunk);
+            flipped += errors ? errors->apply(blocks, codewords.data(), count, cursor) : model->apply(codewords.data(), count);
+        }
+        HAMMING_PROFILE_SCOPE(Write);
+        TraceScope trace("write", chunk);
+        LatencyScope latency(LatencyOp::Write);
+        char* out = text.data();
+        for (std::size_t i = 0; i + 1 < count; i += 2) {
+            std::memcpy(out, codewordText[codewords[i]], 7);
+            std::memcpy(out + 7, codewordText[codewords[i + 1]], 7);
+            out[14] = '\n';
+            out += 15;
+        }
+        outputFile.write(text.data(), out - text.data());
+        Metrics::count(consumed, static_cast<std::size_t>(out - text.data()), count);
+        blocks += count;
+        consumed = 0;
+        ++chunk;
+    };
 
-            for (int j = 0; j < 7; ++j) {
-                outputFile << code1(0, j);  // First 7 bits
+    if (clean) {
+        //Pack the encoder's codewords (bit 6 = column 0) without touching them
+        const auto& encodedMessages = clean->encodedMessages;
+        for (std::size_t start = 0; start < encodedMessages.size(); start += chunkBlocks) {
+            std::size_t count = std::min(chunkBlocks, encodedMessages.size() - start);
+            {
+                HAMMING_PROFILE_SCOPE(Parse);
+                TraceScope trace("parse", chunk);
+                for (std::size_t i = 0; i < count; ++i) {
+                    const auto& block = encodedMessages[start + i];
+                    unsigned char word = 0;
+                    for (int j = 0; j < 7; ++j) word = static_cast<unsigned char>((word << 1) | (block(0, j) & 1));
+                    codewords[i] = word;
+                }
+            }
+            flush(count);
+        }
+    } else if (input == Input::Plain) {
+        //Table-encode the text; newlines are dropped like Encode::processFile
+        std::size_t count = 0;
+        for (;;) {
+            std::size_t length;
+            {
+                HAMMING_PROFILE_SCOPE(Read);
+                TraceScope trace("read", chunk);
+                LatencyScope latency(LatencyOp::Read);
+                inputFile.read(plain.data(), static_cast<std::streamsize>(plain.size()));
+                length = static_cast<std::size_t>(inputFile.gcount());
+            }
+            if (length == 0) break;
+            {
+                HAMMING_PROFILE_SCOPE(Kernel);
+                TraceScope trace("encode", chunk);
+                LatencyScope latency(LatencyOp::Encode);
+                for (std::size_t i = 0; i < length; ++i) {
+                    unsigned char ch = static_cast<unsigned char>(plain[i]);
+                    if (ch == '\n') continue;
+                    codewords[count++] = encodeTable[ch >> 4];
+                    codewords[count++] = encodeTable[ch & 0x0F];
+                }
+            }
+            consumed = length;
+            flush(count);
+            count = 0;
+        }
+    } else {
+        //Existing records; lines that are not 14 binary digits are skipped like Decode
+        std::size_t count = 0, malformed = 0;
+        std::string line;
+        while (std::getline(inputFile, line)) {
+            if (line.size() != 14 || line.find_first_not_of("01") != std::string::npos) {
+                if (!line.empty()) ++malformed;
+                continue;
             }
-            for (int j = 0; j < 7; ++j) {
-                outputFile << code2(0, j);  // Next 7 bits
+            for (int half = 0; half < 2; ++half) {
+                unsigned char word = 0;
+                for (int j = 0; j < 7; ++j) word = static_cast<unsigned char>((word << 1) | (line[half * 7 + j] - '0'));
+                codewords[count++] = word;
+            }
+            consumed += line.size() + 1;
+            if (count == chunkBlocks) {
+                flush(count);
+                count = 0;
             }
-            outputFile << "\n";
         }
+        flush(count);
+        if (malformed) std::cerr << "Skipped " << malformed << " malformed lines in " << fileName << std::endl;
     }
 
     outputFile.close();
-    std::cout << "Error encoding complete. Output written to " << outputFileName << ".\n";
+    std::cout << "Error encoding complete. " << flipped << " bits flipped in " << blocks << " blocks. Output written to "
+              << outputFileName << ".\n";
 }
 
-//Introduces random errors in each Hamming code block
-void ErrorEncode::errorEncodeRand() {
-    auto& encodedMessages = this->getEncodedMessages();  // Reference to encoded messages
+//Merge pass: every fault becomes a (file offset, XOR byte) pair in file order, applied as blocks stream past
+void ErrorEncode::replayFaults() {
+    if (!faults->isOpen()) return;
+    int in = open(fileName.c_str(), O_RDONLY);
+    if (in < 0) {
+        std::cerr << "Error opening file: " << fileName << std::endl;
+        ioFailed = true;
+        return;
+    }
+
+    //Packed containers keep one codeword per byte inside their chunk bodies; text keeps one digit per bit
+    ContainerHeader header;
+    std::vector<ChunkIndexEntry> index;
+    char magic[4] = {};
+    bool packed = pread(in, magic, 4, 0) == 4 && std::memcmp(magic, containerMagic, 4) == 0;
+    if (packed && !readContainerIndex(in, header, index)) {
+        std::cerr << "Error: " << fileName << " is not a valid packed container." << std::endl;
+        ioFailed = true;
+        close(in);
+        return;
+    }
+
+    std::string stem = fileName.substr(0, fileName.find_last_of('.'));
+    if (!packed && stem.size() >= 4 && stem.compare(stem.size() - 4, 4, "_out") == 0) stem.resize(stem.size() - 4);
+    std::string outputFileName = stem + (packed ? "_e.hmc" : "_e_out.txt");
+    int out = open(outputFileName.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+    if (out < 0) {
+        std::cerr << "Error creating output file" << std::endl;
+        ioFailed = true;
+        close(in);
+        return;
+    }
+
+    std::size_t chunk = 0;
+    std::uint64_t chunkStart = 0;  //First codeword of index[chunk]
+    std::uint64_t bit = 0, offset = 0;
+    unsigned char flip = 0;
+    std::size_t applied = 0, outOfRange = 0, misaligned = 0;
+
+    //Locates the next fault; false once the map is exhausted or the rest lies past the data
+    auto nextFault = [&]() {
+        while (faults->next(bit)) {
+            std::uint64_t block = bit / 7;
+            if (packed) {
+                while (chunk < index.size() && block >= chunkStart + index[chunk].length * containerBytesPerByte) {
+                    chunkStart += index[chunk].length * containerBytesPerByte;
+                    ++chunk;
+                }
+                if (chunk == index.size()) {
+                    ++outOfRange;
+                    break;
+                }
+                offset = index[chunk].offset + (block - chunkStart);
+                flip = static_cast<unsigned char>(0x40 >> (bit % 7));
+            } else {
+                offset = bit / 14 * 15 + bit % 14;
+                flip = '0' ^ '1';
+            }
+            return true;
+        }
+        return false;
+    };
 
-    hammingCodeWithErrors.clear();
+    std::vector<char> buffer(copyBlock);
+    bool pending = nextFault();
+    std::uint64_t position = 0;
+    for (;;) {
+        ssize_t n = read(in, buffer.data(), buffer.size());
+        if (n < 0) {
+            std::cerr << "Error reading file: " << fileName << std::endl;
+            ioFailed = true;
+            break;
+        }
+        if (n == 0) break;
 
-    for (auto& encodedMessage : encodedMessages) {
-        int bitPos = rand() % 7;  //Random bit position in the block
-        encodedMessage(0, bitPos) = (encodedMessage(0, bitPos) == 0) ? 1 : 0;  //Flip the bit
+        std::uint64_t end = position + static_cast<std::uint64_t>(n);
+        for (; pending && offset < end; pending = nextFault()) {
+            char& byte = buffer[offset - position];
+            if (!packed && byte != '0' && byte != '1') {
+                ++misaligned;
+                continue;
+            }
+            byte = static_cast<char>(byte ^ flip);
+            ++applied;
+        }
+        if (!writeAll(out, buffer.data(), static_cast<std::size_t>(n))) {
+            std::cerr << "Error writing output file: " << outputFileName << std::endl;
+            ioFailed = true;
+            break;
+        }
+        position = end;
+    }
 
-        hammingCodeWithErrors.push_back(encodedMessage);  
+    close(in);
+    if (close(out) != 0 && !ioFailed) {
+        std::cerr << "Error writing output file: " << outputFileName << std::endl;
+        ioFailed = true;
     }
-}
\ No newline at end of file
+    if (ioFailed) {
+        std::cerr << "Fault replay failed after " << applied << " bits flipped; " << outputFileName << " is incomplete." << std::endl;
+        return;
+    }
+
+    //Whatever is left lies beyond the end of the data
+    for (; pending; pending = nextFault()) ++outOfRange;
+    while (!faults->failed() && faults->next(bit)) ++outOfRange;
+
+    std::cout << "Fault replay complete. " << applied << " bits flipped";
+    if (outOfRange) std::cout << ", " << outOfRange << " faults past the end of the data";
+    if (misaligned) std::cout << ", " << misaligned << " faults outside a 14-digit record";
+    std::cout << ". Output written to " << outputFileName << ".\n";
+}
+
+bool ErrorEncode::replayFailed() const {
+    return ioFailed;
+}
@@ -0,0 +1,189 @@
+// Sparse error overlay
+// Keeps only the corrupted codewords as sorted (index, mask) entries and XORs them into clean
+// codewords as they stream past; saved as delta-coded varints, so files scale with the error count
+// FaultMapReader streams recorded bit offsets from a text file for merge-style replay
+
+#include <iostream>
+#include <fstream>
+#include <string>
+#include <vector>
+#include <algorithm>
+#include <iterator>
+#include <cstring>
+#include <cstdlib>
+#include "HammingErrorMap.h"
+#include "HammingChannel.h"
+
+namespace {
+    const std::uint64_t recordChunk = 1 << 20;  //Codewords per channel call in record()
+
+    void putVarint(std::string& out, std::uint64_t value) {
+        while (value >= 0x80) {
+            out.push_back(static_cast<char>((value & 0x7F) | 0x80));
+            value >>= 7;
+        }
+        out.push_back(static_cast<char>(value));
+    }
+
+    bool getVarint(const std::string& in, std::size_t& pos, std::uint64_t& value) {
+        value = 0;
+        for (int shift = 0; shift < 64 && pos < in.size(); shift += 7) {
+            unsigned char byte = static_cast<unsigned char>(in[pos++]);
+            value |= static_cast<std::uint64_t>(byte & 0x7F) << shift;
+            if (!(byte & 0x80)) return true;
+        }
+        return false;
+    }
+}
+
+
+//ErrorMap class constructor
+ErrorMap::ErrorMap() : blocks(0) {}
+
+
+void ErrorMap::record(Channel& channel, std::uint64_t count) {
+    for (std::uint64_t done = 0; done < count;) {
+        std::uint64_t chunk = std::min(recordChunk, count - done);
+        positions.clear();
+        channel.corrupt(chunk, positions);
+
+        //Positions ascend, so flips of one codeword are adjacent
+        for (std::uint64_t position : positions) {
+            std::uint64_t block = blocks + done + position / 7;
+            unsigned char bit = static_cast<unsigned char>(0x40 >> (position % 7));
+            if (!entries.empty() && entries.back().block == block) entries.back().mask ^= bit;
+            else entries.push_back(Entry{block, bit});
+        }
+        done += chunk;
+    }
+    blocks += count;
+}
+
+std::size_t ErrorMap::apply(std::uint64_t firstBlock, unsigned char* codewords, std::size_t count, std::size_t& cursor) const {
+    if (cursor > entries.size() || (cursor < entries.size() && entries[cursor].block < firstBlock)
+        || (cursor > 0 && entries[cursor - 1].block >= firstBlock)) {
+        cursor = static_cast<std::size_t>(std::lower_bound(entries.begin(), entries.end(), firstBlock,
+            [](const Entry& entry, std::uint64_t block) { return entry.block < block; }) - entries.begin());
+    }
+
+    std::size_t flipped = 0;
+    std::uint64_t end = firstBlock + count;
+    for (; cursor < entries.size() && entries[cursor].block < end; ++cursor) {
+        codewords[entries[cursor].block - firstBlock] ^= entries[cursor].mask;
+        flipped += static_cast<std::size_t>(__builtin_popcount(entries[cursor].mask));
+    }
+    return flipped;
+}
+
+bool ErrorMap::save(const std::string& path) const {
+    std::string out(24, '\0');
+    std::uint64_t count = entries.size();
+    std::memcpy(&out[0], &errorMapMagic, 4);
+    std::memcpy(&out[4], &errorMapVersion, 4);
+    std::memcpy(&out[8], &count, 8);
+    std::memcpy(&out[16], &blocks, 8);
+
+    std::uint64_t previous = 0;
+    for (const Entry& entry : entries) {
+        putVarint(out, entry.block - previous);
+        out.push_back(static_cast<char>(entry.mask));
+        previous = entry.block;
+    }
+
+    std::ofstream file(path, std::ios::out | std::ios::binary | std::ios::trunc);
+    if (!file.is_open() || !file.write(out.data(), static_cast<std::streamsize>(out.size()))) {
+        std::cerr << "Error writing error map: " << path << std::endl;
+        return false;
+    }
+    return true;
+}
+
+bool ErrorMap::load(const std::string& path) {
+    std::ifstream file(path, std::ios::in | std::ios::binary);
+    if (!file.is_open()) {
+        std::cerr << "Error opening error map: " << path << std::endl;
+        return false;
+    }
+    std::string in((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+
+    std::uint32_t magic = 0, version = 0;
+    std::uint64_t count = 0, covered = 0;
+    if (in.size() >= 24) {
+        std::memcpy(&magic, &in[0], 4);
+        std::memcpy(&version, &in[4], 4);
+        std::memcpy(&count, &in[8], 8);
+        std::memcpy(&covered, &in[16], 8);
+    }
+    if (magic != errorMapMagic || version != errorMapVersion || count > (in.size() - 24) / 2) {
+        std::cerr << "Error: " << path << " is not an error map." << std::endl;
+        return false;
+    }
+
+    std::vector<Entry> loaded;
+    loaded.reserve(static_cast<std::size_t>(count));
+    std::size_t pos = 24;
+    std::uint64_t block = 0;
+    for (std::uint64_t i = 0; i < count; ++i) {
+        std::uint64_t delta;
+        if (!getVarint(in, pos, delta) || pos >= in.size() || (i > 0 && delta == 0)) {
+            std::cerr << "Error: error map " << path << " is truncated or corrupt." << std::endl;
+            return false;
+        }
+        block += delta;
+        loaded.push_back(Entry{block, static_cast<unsigned char>(in[pos++] & 0x7F)});
+    }
+
+    entries.swap(loaded);
+    blocks = std::max(covered, entries.empty() ? 0 : entries.back().block + 1);
+    return true;
+}
+
+const std::vector<ErrorMap::Entry>& ErrorMap::getEntries() const {
+    return entries;
+}
+
+std::uint64_t ErrorMap::getBlocks() const {
+    return blocks;
+}
+
+std::uint64_t ErrorMap::countFlips() const {
+    std::uint64_t flips = 0;
+    for (const Entry& entry : entries) flips += static_cast<std::uint64_t>(__builtin_popcount(entry.mask));
+    return flips;
+}
+
+
+//FaultMapReader class constructor
+FaultMapReader::FaultMapReader(const std::string& path) : file(path), path(path), lineNumber(0), previous(0), bad(false) {
+    if (!file.is_open()) std::cerr << "Error opening fault map: " << path << std::endl;
+}
+
+bool FaultMapReader::isOpen() const {
+    return file.is_open();
+}
+
+bool FaultMapReader::next(std::uint64_t& offset) {
+    while (!bad && std::getline(file, line)) {
+        ++lineNumber;
+        std::size_t start = line.find_first_not_of(" \t\r");
+        if (start == std::string::npos || line[start] == '#') continue;
+
+        char* end;
+        offset = std::strtoull(line.c_str() + start, &end, 10);
+        if (end == line.c_str() + start || line.find_first_not_of(" \t\r", static_cast<std::size_t>(end - line.c_str())) != std::string::npos) {
+            std::cerr << "Error: fault map " << path << " line " << lineNumber << " is not a bit offset." << std::endl;
+            bad = true;
+        } else if (offset < previous) {
+            std::cerr << "Error: fault map " << path << " is not sorted at line " << lineNumber << "." << std::endl;
+            bad = true;
+        } else {
+            previous = offset;
+            return true;
+        }
+    }
+    return false;
+}
+
+bool FaultMapReader::failed() const {
+    return bad;
+}
@@ -0,0 +1,156 @@
+/* Colton Criswell and Zach Hamby
+ * Final Project - CS-300
+ */
+
+#ifndef HAMMING_ERROR_MAP_H
+#define HAMMING_ERROR_MAP_H
+
+#include <cstddef>
+#include <cstdint>
+#include <fstream>
+#include <string>
+#include <vector>
+
+class Channel;
+
+/*
+ * Error map file (little-endian):
+ *   "HMEM" magic, u32 version, u64 entry count, u64 codewords covered
+ *   then per entry: LEB128 varint of the codeword index minus the previous entry's index, one mask byte
+ */
+
+static const std::uint32_t errorMapMagic = 0x4D454D48;  ///< "HMEM"
+static const std::uint32_t errorMapVersion = 1;         ///< Current file version
+
+/**
+ * @class ErrorMap
+ * @brief Sparse error overlay: a sorted list of (codeword index, 7-bit flip mask) entries.
+ *
+ * Only corrupted codewords have an entry, so memory and disk scale with the number of errors.
+ * The overlay is applied while clean codewords stream past (to a writer or straight into a
+ * decoder), so a fault experiment never needs a corrupted copy of the data. Masks use the packed
+ * codeword layout: bit 6 is column 0.
+ */
+class ErrorMap {
+
+    public:
+        /**
+         * @struct Entry
+         * @brief Flips of one codeword.
+         */
+        struct Entry {
+            std::uint64_t block;  ///< Codeword index in the stream
+            unsigned char mask;   ///< Bits to flip (bit 6 = column 0)
+        };
+
+        /**
+         * @brief Constructor for an empty ErrorMap.
+         */
+        ErrorMap();
+
+        /**
+         * @brief Draws the flips of the next codewords from a channel and appends them.
+         * @param channel The channel model; its stream continues from where it stopped.
+         * @param blocks Number of codewords to cover.
+         */
+        void record(Channel& channel, std::uint64_t blocks);
+
+        /**
+         * @brief XORs the overlay into a run of consecutive codewords.
+         *
+         * Sequential callers pass the same cursor every time, so each entry is visited once; a
+         * cursor that does not fit firstBlock is repositioned by binary search.
+         * @param firstBlock Index of codewords[0] in the stream.
+         * @param codewords Packed codewords, corrupted in place.
+         * @param count Number of codewords.
+         * @param cursor Entry index to resume from (start with 0).
+         * @return Number of bits flipped.
+         */
+        std::size_t apply(std::uint64_t firstBlock, unsigned char* codewords, std::size_t count, std::size_t& cursor) const;
+
+        /**
+         * @brief Writes the map in the compact file format.
+         * @param path Destination file.
+         * @return False if the file could not be written.
+         */
+        bool save(const std::string& path) const;
+
+        /**
+         * @brief Replaces the map with one read from a file.
+         * @param path Source file.
+         * @return False if the file is missing, truncated or not an error map.
+         */
+        bool load(const std::string& path);
+
+        /**
+         * @brief Getter for the entries.
+         * @return Entries sorted by codeword index.
+         */
+        const std::vector<Entry>& getEntries() const;
+
+        /**
+         * @brief Getter for the number of codewords the map covers.
+         * @return Codewords recorded (entries lie below this index).
+         */
+        std::uint64_t getBlocks() const;
+
+        /**
+         * @brief Counts the flipped bits.
+         * @return Total set bits over all masks.
+         */
+        std::uint64_t countFlips() const;
+
+    private:
+        std::vector<Entry> entries;             ///< Sorted by block, one per corrupted codeword
+        std::uint64_t blocks;                   ///< Codewords covered
+        std::vector<std::uint64_t> positions;   ///< Scratch buffer for record()
+};
+
+/**
+ * @class FaultMapReader
+ * @brief Streams a recorded fault map: one flipped bit offset per line, in ascending order.
+ *
+ * Offsets count bits of the codeword stream, bit j of codeword i being 7 * i + j (the numbering
+ * of the channel models). A map is tied to one stored format: the text encoding drops newlines
+ * and the packed container keeps them, so the same codeword index names different data in each.
+ * Blank lines and lines starting with '#' are ignored. The map is read as it is consumed, so it
+ * can be far larger than memory.
+ */
+class FaultMapReader {
+
+    public:
+        /**
+         * @brief Constructor for FaultMapReader class.
+         * @param path The fault map file.
+         */
+        FaultMapReader(const std::string& path);
+
+        /**
+         * @brief Checks whether the file was opened.
+         * @return True if readable.
+         */
+        bool isOpen() const;
+
+        /**
+         * @brief Reads the next offset.
+         * @param offset Receives the bit offset.
+         * @return False at the end of the map, or if a line is malformed or out of order (reported on std::cerr).
+         */
+        bool next(std::uint64_t& offset);
+
+        /**
+         * @brief Checks whether reading stopped on a bad line rather than the end of the map.
+         * @return True if a line was malformed or out of order.
+         */
+        bool failed() const;
+
+    private:
+        std::ifstream file;       ///< The map
+        std::string path;         ///< Name for messages
+        std::string line;         ///< Current line
+        std::uint64_t lineNumber; ///< Lines read so far
+        std::uint64_t previous;   ///< Last offset returned
+        bool bad;                 ///< A line was malformed or out of order
+};
+
+#endif
@@ -0,0 +1,188 @@
+// Latency histograms (see HammingLatency.h)
+// Each thread records into its own histograms with relaxed load/store pairs, so recording never
+// contends; a dump sums every thread's buckets, including threads that have since exited
+
+#include <iostream>
+#include <algorithm>
+#include <iomanip>
+#include <fstream>
+#include <sstream>
+#include <atomic>
+#include <bit>
+#include <memory>
+#include <mutex>
+#include <vector>
+#include "HammingLatency.h"
+
+namespace {
+    const int opCount = static_cast<int>(LatencyOp::Count);
+    const char* const opNames[opCount] = {"encode", "decode", "request", "read", "write"};
+    const double quantiles[] = {0.5, 0.9, 0.99, 0.999};
+    const char* const quantileNames[] = {"p50", "p90", "p99", "p999"};
+
+    std::atomic<bool> recording{false};
+
+    //Only the owning thread writes, so a relaxed load and store is enough and a dump may read at any time
+    void add(std::atomic<std::uint64_t>& total, std::uint64_t value) {
+        total.store(total.load(std::memory_order_relaxed) + value, std::memory_order_relaxed);
+    }
+
+    struct Histogram {
+        std::atomic<std::uint64_t> count{0};
+        std::atomic<std::uint64_t> sum{0};
+        std::atomic<std::uint64_t> max{0};
+        std::atomic<std::uint64_t> buckets[Latency::bucketCount] = {};
+    };
+
+    struct ThreadHistograms {
+        Histogram ops[opCount];
+    };
+
+    std::mutex registryMutex;
+    std::vector<std::shared_ptr<ThreadHistograms>> registry;  //Every thread that recorded, exited ones included
+
+    ThreadHistograms& local() {
+        thread_local std::shared_ptr<ThreadHistograms> histograms = [] {
+            auto created = std::make_shared<ThreadHistograms>();
+            std::lock_guard<std::mutex> lock(registryMutex);
+            registry.push_back(created);
+            return created;
+        }();
+        return *histograms;
+    }
+
+    //Sum of every thread's histogram of one operation
+    struct Merged {
+        std::uint64_t count = 0;
+        std::uint64_t sum = 0;
+        std::uint64_t max = 0;
+        std::vector<std::uint64_t> buckets = std::vector<std::uint64_t>(Latency::bucketCount);
+
+        //Upper bound of the bucket holding the q-th value, capped at the largest value seen
+        std::uint64_t quantile(double q) const {
+            std::uint64_t rank = static_cast<std::uint64_t>(q * static_cast<double>(count - 1)) + 1, seen = 0;
+            for (int b = 0; b < Latency::bucketCount; ++b) {
+                seen += buckets[b];
+                if (seen >= rank) return std::min(Latency::bucketHigh(b), max);
+            }
+            return max;
+        }
+    };
+
+    std::vector<Merged> merge() {
+        std::vector<std::shared_ptr<ThreadHistograms>> threads;
+        {
+            std::lock_guard<std::mutex> lock(registryMutex);
+            threads = registry;
+        }
+        std::vector<Merged> merged(opCount);
+        for (const auto& thread : threads) {
+            for (int o = 0; o < opCount; ++o) {
+                const Histogram& histogram = thread->ops[o];
+                merged[o].count += histogram.count.load(std::memory_order_relaxed);
+                merged[o].sum += histogram.sum.load(std::memory_order_relaxed);
+                merged[o].max = std::max(merged[o].max, histogram.max.load(std::memory_order_relaxed));
+                for (int b = 0; b < Latency::bucketCount; ++b) merged[o].buckets[b] += histogram.buckets[b].load(std::memory_order_relaxed);
+            }
+        }
+        return merged;
+    }
+}
+
+
+void Latency::enable() {
+    recording.store(true, std::memory_order_relaxed);
+}
+
+bool Latency::enabled() {
+    return recording.load(std::memory_order_relaxed);
+}
+
+void Latency::record(LatencyOp op, std::uint64_t nanoseconds) {
+    Histogram& histogram = local().ops[static_cast<int>(op)];
+    add(histogram.count, 1);
+    add(histogram.sum, nanoseconds);
+    add(histogram.buckets[bucketOf(nanoseconds)], 1);
+    if (nanoseconds > histogram.max.load(std::memory_order_relaxed)) histogram.max.store(nanoseconds, std::memory_order_relaxed);
+}
+
+
+//Values below two powers of sub-buckets get a bucket each; above, each power of two is split
+//into 1 << subBucketBits equal buckets
+int Latency::bucketOf(std::uint64_t nanoseconds) {
+    const std::uint64_t linear = 2u << subBucketBits;
+    if (nanoseconds < linear) return static_cast<int>(nanoseconds);
+    int shift = (63 - std::countl_zero(nanoseconds)) - subBucketBits;
+    return ((shift + 1) << subBucketBits) + static_cast<int>((nanoseconds >> shift) - (1u << subBucketBits));
+}
+
+std::uint64_t Latency::bucketLow(int bucket) {
+    if (bucket < (2 << subBucketBits)) return static_cast<std::uint64_t>(bucket);
+    int shift = (bucket >> subBucketBits) - 1;
+    std::uint64_t top = (1u << subBucketBits) + static_cast<std::uint64_t>(bucket & ((1 << subBucketBits) - 1));
+    return top << shift;
+}
+
+std::uint64_t Latency::bucketHigh(int bucket) {
+    if (bucket < (2 << subBucketBits)) return static_cast<std::uint64_t>(bucket);
+    int shift = (bucket >> subBucketBits) - 1;
+    return bucketLow(bucket) + ((std::uint64_t(1) << shift) - 1);
+}
+
+
+void Latency::writeText(std::ostream& out) {
+    std::vector<Merged> merged = merge();
+    std::ostringstream text;
+    text << "Latency (microseconds)\n"
+         << "  op             count       mean        p50        p90        p99      p99.9        max\n"
+         << std::fixed << std::setprecision(2);
+    for (int o = 0; o < opCount; ++o) {
+        const Merged& op = merged[o];
+        if (!op.count) continue;
+        text << "  " << std::left << std::setw(8) << opNames[o] << std::right << std::setw(12) << op.count
+             << std::setw(11) << static_cast<double>(op.sum) / static_cast<double>(op.count) / 1e3;
+        for (double q : quantiles) text << std::setw(11) << static_cast<double>(op.quantile(q)) / 1e3;
+        text << std::setw(11) << static_cast<double>(op.max) / 1e3 << "\n";
+    }
+    out << text.str() << std::flush;
+}
+
+void Latency::writeJson(std::ostream& out) {
+    std::vector<Merged> merged = merge();
+    std::ostringstream json;
+    json << "{\"unit\":\"ns\",\"sub_buckets\":" << (1 << subBucketBits) << ",\"ops\":{";
+    bool first = true;
+    for (int o = 0; o < opCount; ++o) {
+        const Merged& op = merged[o];
+        if (!op.count) continue;
+        json << (first ? "\n" : ",\n") << "\"" << opNames[o] << "\":{\"count\":" << op.count << ",\"mean\":" << op.sum / op.count;
+        for (int q = 0; q < 4; ++q) json << ",\"" << quantileNames[q] << "\":" << op.quantile(quantiles[q]);
+        json << ",\"max\":" << op.max << ",\"buckets\":[";
+        bool firstBucket = true;
+        for (int b = 0; b < bucketCount; ++b) {
+            if (!op.buckets[b]) continue;
+            json << (firstBucket ? "" : ",") << "[" << bucketLow(b) << "," << bucketHigh(b) << "," << op.buckets[b] << "]";
+            firstBucket = false;
+        }
+        json << "]}";
+        first = false;
+    }
+    json << "\n}}\n";
+    out << json.str() << std::flush;
+}
+
+bool Latency::dump(const std::string& path) {
+    if (path == "-") {
+        writeText(std::cerr);
+        return true;
+    }
+    std::ofstream out(path, std::ios::out | std::ios::trunc);
+    if (!out.is_open()) {
+        std::cerr << "Error creating output file: " << path << std::endl;
+        return false;
+    }
+    bool json = path.size() >= 5 && path.compare(path.size() - 5, 5, ".json") == 0;
+    if (json) writeJson(out);
+    else writeText(out);
+    return true;
+}
@@ -0,0 +1,137 @@
+/* Colton Criswell and Zach Hamby
+ * Final Project - CS-300
+ */
+
+#ifndef HAMMING_LATENCY_H
+#define HAMMING_LATENCY_H
+
+#include <chrono>
+#include <cstdint>
+#include <ostream>
+#include <string>
+
+/*
+ * Latency histograms of individual codec calls and I/O operations.
+ *
+ * Off until Latency::enable() (main --latency=<file>); a disabled scope costs one relaxed load.
+ * Enabled, every scope reads the steady clock twice and bumps one bucket of a log-linear
+ * histogram owned by the calling thread (16 linear sub-buckets per power of two nanoseconds,
+ * so quantiles are within 1/16 of the true value). Dumps merge every thread's histograms.
+ */
+
+/**
+ * @brief Operations with a latency histogram.
+ */
+enum class LatencyOp {
+    Encode,  ///< One encodeToText call or one chunk through a table-driven encode loop
+    Decode,  ///< One decodeFromText call or one chunk through a table-driven decode loop
+    Request, ///< One daemon request, from parsed header to appended response
+    Read,    ///< One chunk or record read from input, or one drain of a client socket
+    Write,   ///< One chunk written to output, or one flush of a client's responses
+    Count    ///< Number of operations
+};
+
+/**
+ * @class Latency
+ * @brief Per-thread latency histograms, merged when dumped.
+ */
+class Latency {
+
+    public:
+        static const int subBucketBits = 4;                  ///< log2 of the linear sub-buckets per power of two
+        static const int bucketCount = 64 << subBucketBits;  ///< Buckets covering every 64-bit nanosecond count
+
+        /**
+         * @brief Turns recording on for every thread.
+         */
+        static void enable();
+
+        /**
+         * @brief Checks whether recording is on.
+         * @return True once enable() was called.
+         */
+        static bool enabled();
+
+        /**
+         * @brief Records one operation on the calling thread's histogram.
+         * @param op The operation.
+         * @param nanoseconds How long it took.
+         */
+        static void record(LatencyOp op, std::uint64_t nanoseconds);
+
+        /**
+         * @brief Writes count, mean, p50, p90, p99, p99.9 and max per operation as a table.
+         * @param out Destination stream.
+         */
+        static void writeText(std::ostream& out);
+
+        /**
+         * @brief Writes the same summary plus the non-empty buckets as JSON.
+         * @param out Destination stream.
+         */
+        static void writeJson(std::ostream& out);
+
+        /**
+         * @brief Writes the histograms to a file: JSON if the name ends in .json, otherwise text; "-" is std::cerr.
+         * @param path Destination.
+         * @return True if the file was written.
+         */
+        static bool dump(const std::string& path);
+
+        /**
+         * @brief Maps a duration to its bucket.
+         * @param nanoseconds The duration.
+         * @return Bucket index, below bucketCount.
+         */
+        static int bucketOf(std::uint64_t nanoseconds);
+
+        /**
+         * @brief Smallest duration of a bucket.
+         * @param bucket Bucket index.
+         * @return Lower bound in nanoseconds.
+         */
+        static std::uint64_t bucketLow(int bucket);
+
+        /**
+         * @brief Largest duration of a bucket.
+         * @param bucket Bucket index.
+         * @return Upper bound in nanoseconds.
+         */
+        static std::uint64_t bucketHigh(int bucket);
+};
+
+/**
+ * @class LatencyScope
+ * @brief Records the lifetime of a block when recording is on.
+ */
+class LatencyScope {
+
+    public:
+        /**
+         * @brief Constructor for LatencyScope class; starts the clock if recording is on.
+         * @param op The operation to record.
+         */
+        explicit LatencyScope(LatencyOp op) : op(op), active(Latency::enabled()) {
+            if (active) start = std::chrono::steady_clock::now();
+        }
+
+        /**
+         * @brief Destructor for LatencyScope class; records the elapsed time.
+         */
+        ~LatencyScope() {
+            if (active) {
+                auto elapsed = std::chrono::steady_clock::now() - start;
+                Latency::record(op, static_cast<std::uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(elapsed).count()));
+            }
+        }
+
+        LatencyScope(const LatencyScope&) = delete;
+        LatencyScope& operator=(const LatencyScope&) = delete;
+
+    private:
+        LatencyOp op;                                  ///< Operation to record
+        bool active;                                   ///< Whether recording was on at construction
+        std::chrono::steady_clock::time_point start;   ///< Construction time
+};
+
+#endif
@@ -0,0 +1,175 @@
+// Metrics exposition (see HammingMetrics.h)
+// Codec counters live in per-thread relaxed atomics that only their thread writes, so counting
+// never contends; queue gauges are shared and changed once per chunk or task. A helper thread
+// sums everything into a Prometheus text file on a timer
+
+#include <iostream>
+#include <fstream>
+#include <sstream>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdio>
+#include <cstdlib>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+#include "HammingMetrics.h"
+
+namespace {
+    const int counterCount = 5;
+    const char* const counterNames[counterCount] = {
+        "hamming_bytes_in_total", "hamming_bytes_out_total", "hamming_codewords_total",
+        "hamming_corrected_codewords_total", "hamming_uncorrectable_codewords_total"};
+    const char* const counterHelp[counterCount] = {
+        "Bytes consumed by the codec.", "Bytes produced by the codec.", "Codewords encoded or checked.",
+        "Codewords with a corrected single-bit error.", "Codewords found uncorrectable."};
+    const int queueCount = static_cast<int>(MetricQueue::Count);
+    const char* const queueNames[queueCount] = {"pool", "pipeline_codec", "pipeline_writer"};
+
+    std::atomic<bool> counting{false};
+    std::atomic<std::int64_t> queueDepths[queueCount] = {};
+
+    //Only the owning thread writes, so a relaxed load and store is enough and the writer may read at any time
+    void add(std::atomic<std::uint64_t>& total, std::uint64_t value) {
+        total.store(total.load(std::memory_order_relaxed) + value, std::memory_order_relaxed);
+    }
+
+    struct ThreadCounters {
+        std::atomic<std::uint64_t> values[counterCount] = {};
+    };
+
+    std::mutex registryMutex;
+    std::vector<std::shared_ptr<ThreadCounters>> registry;  //Every thread that counted, exited ones included
+
+    ThreadCounters& local() {
+        thread_local std::shared_ptr<ThreadCounters> counters = [] {
+            auto created = std::make_shared<ThreadCounters>();
+            std::lock_guard<std::mutex> lock(registryMutex);
+            registry.push_back(created);
+            return created;
+        }();
+        return *counters;
+    }
+
+    //Helper thread state; the loop rewrites once more after stop() so the file ends with the final totals
+    std::mutex fileMutex;
+    std::condition_variable stopSignal;
+    bool stopping = false;
+    std::thread writer;
+    std::string metricsPath;
+    std::chrono::steady_clock::time_point started, lastSample;
+    std::uint64_t lastBytes = 0;
+
+    //Rewrites the file through a temporary so it is replaced atomically
+    void rewrite() {
+        std::string temporary = metricsPath + ".tmp";
+        {
+            std::ofstream out(temporary, std::ios::out | std::ios::trunc);
+            if (!out.is_open()) {
+                std::cerr << "Error creating output file: " << temporary << std::endl;
+                return;
+            }
+            Metrics::write(out);
+        }
+        if (std::rename(temporary.c_str(), metricsPath.c_str()) != 0) std::cerr << "Error writing output file: " << metricsPath << std::endl;
+    }
+}
+
+
+void Metrics::enable(const std::string& path, unsigned intervalSeconds) {
+    if (counting.exchange(true)) return;
+    metricsPath = path;
+    started = lastSample = std::chrono::steady_clock::now();
+    if (path.empty()) return;
+    rewrite();
+    writer = std::thread([intervalSeconds] {
+        std::unique_lock<std::mutex> lock(fileMutex);
+        while (!stopping) {
+            stopSignal.wait_for(lock, std::chrono::seconds(intervalSeconds ? intervalSeconds : 1), [] { return stopping; });
+            lock.unlock();
+            rewrite();
+            lock.lock();
+        }
+    });
+    std::atexit(stop);
+}
+
+bool Metrics::enabled() {
+    return counting.load(std::memory_order_relaxed);
+}
+
+void Metrics::count(std::uint64_t bytesIn, std::uint64_t bytesOut, std::uint64_t codewords, std::uint64_t corrected, std::uint64_t uncorrectable) {
+    if (!enabled()) return;
+    ThreadCounters& counters = local();
+    add(counters.values[0], bytesIn);
+    add(counters.values[1], bytesOut);
+    add(counters.values[2], codewords);
+    if (corrected) add(counters.values[3], corrected);
+    if (uncorrectable) add(counters.values[4], uncorrectable);
+}
+
+void Metrics::queue(MetricQueue queue, std::int64_t delta) {
+    if (!enabled()) return;
+    queueDepths[static_cast<int>(queue)].fetch_add(delta, std::memory_order_relaxed);
+}
+
+
+std::uint64_t Metrics::bytesIn() {
+    std::uint64_t total = 0;
+    std::lock_guard<std::mutex> lock(registryMutex);
+    for (const auto& thread : registry) total += thread->values[0].load(std::memory_order_relaxed);
+    return total;
+}
+
+void Metrics::write(std::ostream& out) {
+    std::uint64_t totals[counterCount] = {};
+    {
+        std::lock_guard<std::mutex> lock(registryMutex);
+        for (const auto& thread : registry) {
+            for (int c = 0; c < counterCount; ++c) totals[c] += thread->values[c].load(std::memory_order_relaxed);
+        }
+    }
+
+    //Throughput of the input since the previous write
+    static std::mutex sampleMutex;
+    double throughput;
+    std::chrono::steady_clock::time_point now = std::chrono::steady_clock::now();
+    {
+        std::lock_guard<std::mutex> lock(sampleMutex);
+        double seconds = std::chrono::duration<double>(now - lastSample).count();
+        throughput = seconds > 0 ? static_cast<double>(totals[0] - lastBytes) / seconds : 0;
+        lastSample = now;
+        lastBytes = totals[0];
+    }
+
+    std::ostringstream text;
+    for (int c = 0; c < counterCount; ++c) {
+        text << "# HELP " << counterNames[c] << " " << counterHelp[c] << "\n"
+             << "# TYPE " << counterNames[c] << " counter\n"
+             << counterNames[c] << " " << totals[c] << "\n";
+    }
+    text << "# HELP hamming_throughput_bytes_per_second Input bytes per second since the previous rewrite.\n"
+         << "# TYPE hamming_throughput_bytes_per_second gauge\n"
+         << "hamming_throughput_bytes_per_second " << throughput << "\n"
+         << "# HELP hamming_queue_depth Entries waiting in a queue.\n"
+         << "# TYPE hamming_queue_depth gauge\n";
+    for (int q = 0; q < queueCount; ++q) {
+        text << "hamming_queue_depth{queue=\"" << queueNames[q] << "\"} " << queueDepths[q].load(std::memory_order_relaxed) << "\n";
+    }
+    text << "# HELP hamming_uptime_seconds Seconds since metrics were enabled.\n"
+         << "# TYPE hamming_uptime_seconds gauge\n"
+         << "hamming_uptime_seconds " << std::chrono::duration<double>(now - started).count() << "\n";
+    out << text.str() << std::flush;
+}
+
+void Metrics::stop() {
+    {
+        std::lock_guard<std::mutex> lock(fileMutex);
+        if (stopping) return;
+        stopping = true;
+    }
+    stopSignal.notify_all();
+    if (writer.joinable()) writer.join();
+}
@@ -0,0 +1,90 @@
+/* Colton Criswell and Zach Hamby
+ * Final Project - CS-300
+ */
+
+#ifndef HAMMING_METRICS_H
+#define HAMMING_METRICS_H
+
+#include <cstdint>
+#include <ostream>
+#include <string>
+
+/*
+ * Live counters for long-running jobs, exposed as a Prometheus text-format file.
+ *
+ * Off until Metrics::enable() (main --metrics=<file>); until then every call returns after one
+ * relaxed load. Enabled, codec counters go to the calling thread's own relaxed atomics, queue
+ * depths to shared gauges, and a helper thread rewrites the file every interval (write to a
+ * temporary file, then rename, so a scraper never sees half a file) and once more at exit.
+ * The file suits node_exporter's textfile collector or a plain `cat`.
+ */
+
+/**
+ * @brief Queues whose depth is exported as a gauge.
+ */
+enum class MetricQueue {
+    Pool,           ///< Tasks waiting in thread pools
+    PipelineCodec,  ///< Pipeline chunks read but not yet through a codec
+    PipelineWriter, ///< Pipeline chunks coded but not yet written
+    Count           ///< Number of queues
+};
+
+/**
+ * @class Metrics
+ * @brief Codec counters and queue gauges, periodically written as Prometheus text.
+ */
+class Metrics {
+
+    public:
+        static const unsigned defaultInterval = 5; ///< Seconds between rewrites
+
+        /**
+         * @brief Turns counting on and starts rewriting the metrics file.
+         * @param path File to rewrite; empty to count without writing a file.
+         * @param intervalSeconds Seconds between rewrites.
+         */
+        static void enable(const std::string& path, unsigned intervalSeconds = defaultInterval);
+
+        /**
+         * @brief Checks whether counting is on.
+         * @return True once enable() was called.
+         */
+        static bool enabled();
+
+        /**
+         * @brief Adds one batch of codec work to the calling thread's counters.
+         * @param bytesIn Bytes the codec consumed.
+         * @param bytesOut Bytes the codec produced.
+         * @param codewords 7-bit codewords encoded or checked.
+         * @param corrected Codewords that had a single-bit error corrected.
+         * @param uncorrectable Codewords found uncorrectable.
+         */
+        static void count(std::uint64_t bytesIn, std::uint64_t bytesOut, std::uint64_t codewords,
+                          std::uint64_t corrected = 0, std::uint64_t uncorrectable = 0);
+
+        /**
+         * @brief Changes the depth of a queue.
+         * @param queue The queue.
+         * @param delta Entries added (positive) or removed (negative).
+         */
+        static void queue(MetricQueue queue, std::int64_t delta);
+
+        /**
+         * @brief Sums the input bytes counted by every thread.
+         * @return Bytes consumed by the codec so far.
+         */
+        static std::uint64_t bytesIn();
+
+        /**
+         * @brief Writes every metric in Prometheus text format.
+         * @param out Destination stream.
+         */
+        static void write(std::ostream& out);
+
+        /**
+         * @brief Stops the helper thread after a final rewrite; called at exit.
+         */
+        static void stop();
+};
+
+#endif
@@ -0,0 +1,96 @@
+// Inherit from Hamming Decode
+// Decodes a clean encoded text file with a sparse error overlay XORed in on the fly
+// Codewords are parsed chunk by chunk, the overlay flips the few corrupted ones, and the
+// lookup tables correct and decode them; no corrupted copy of the file is ever written
+
+#include <iostream>
+#include <fstream>
+#include <string>
+#include <vector>
+#include "Hamming.h"
+#include "HammingErrorMap.h"
+#include "HammingLatency.h"
+#include "HammingMetrics.h"
+#include "HammingProfile.h"
+#include "HammingTrace.h"
+
+namespace {
+    const std::size_t chunkBlocks = 1 << 16;  //Codewords per chunk (even, so records never split)
+}
+
+
+//OverlayDecode class constructor
+OverlayDecode::OverlayDecode(std::string file, const ErrorMap& errors) : Decode(file, false), errors(errors) {
+    processFile();
+}
+OverlayDecode::~OverlayDecode() {}
+
+
+void OverlayDecode::processFile() {
+    stats = DecodeStats();
+    std::ifstream inputFile(fileName, std::ios::in | std::ios::binary);
+    if (!inputFile.is_open()) {
+        std::cerr << "Error opening file: " << fileName << std::endl;
+        return;
+    }
+    std::string outputFileName = fileName.substr(0, fileName.find_last_of('.')) + "_overlay_decoded.txt";
+    std::ofstream outputFile(outputFileName, std::ios::out | std::ios::binary | std::ios::trunc);
+    if (!outputFile.is_open()) {
+        std::cerr << "Error creating output file" << std::endl;
+        return;
+    }
+
+    std::vector<unsigned char> codewords(chunkBlocks);
+    std::vector<char> decoded(chunkBlocks / 2);
+    std::size_t count = 0, cursor = 0, flipped = 0;
+    std::uint64_t blocks = 0;  //Codewords before this chunk
+    std::size_t chunk = 0;     //Sequence number of this chunk
+
+    //Overlay, correct and decode a chunk of codewords
+    auto flush = [&]() {
+        {
+            HAMMING_PROFILE_SCOPE(Inject);
+            TraceScope trace("inject", chunk);
+            flipped += errors.apply(blocks, codewords.data(), count, cursor);
+        }
+        {
+            HAMMING_PROFILE_SCOPE(Kernel);
+            TraceScope trace("decode", chunk);
+            LatencyScope latency(LatencyOp::Decode);
+            std::size_t correctedBefore = stats.corrected;
+            for (std::size_t i = 0; i + 1 < count; i += 2) {
+                stats.record(syndromeTable[codewords[i]]);
+                stats.record(syndromeTable[codewords[i + 1]]);
+                decoded[i / 2] = static_cast<char>((correctTable[codewords[i]] << 4) | correctTable[codewords[i + 1]]);
+            }
+            Metrics::count(count / 2 * 15, count / 2, count, stats.corrected - correctedBefore);
+        }
+        HAMMING_PROFILE_SCOPE(Write);
+        TraceScope trace("write", chunk);
+        LatencyScope latency(LatencyOp::Write);
+        outputFile.write(decoded.data(), static_cast<std::streamsize>(count / 2));
+        blocks += count;
+        count = 0;
+        ++chunk;
+    };
+
+    std::string line;
+    while (std::getline(inputFile, line)) {
+        if (line.size() != 14 || line.find_first_not_of("01") != std::string::npos) {
+            if (!line.empty()) ++stats.malformed;
+            continue;
+        }
+        for (int half = 0; half < 2; ++half) {
+            unsigned char word = 0;
+            for (int j = 0; j < 7; ++j) word = static_cast<unsigned char>((word << 1) | (line[half * 7 + j] - '0'));
+            codewords[count++] = word;
+        }
+        if (count == chunkBlocks) flush();
+    }
+    flush();
+
+    outputFile.close();
+    std::cout << "Overlay decoding complete. " << flipped << " bits flipped, ";
+    stats.print(std::cout);
+    std::cout << " Output written to " << outputFileName << ".\n";
+}
@@ -0,0 +1,262 @@
+// Packed chunked container (.hmc)
+// Every byte is split into two 4-bit messages, each stored as one 7-bit codeword per byte
+// Chunks are listed in a trailer index with an optional CRC32C of their plaintext,
+// which catches the 2- and 3-bit errors that Hamming(7,4) silently miscorrects
+
+#include <iostream>
+#include <fstream>
+#include <string>
+#include <vector>
+#include <cstring>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/stat.h>
+#include "Hamming.h"
+#include "HammingContainer.h"
+#include "HammingLatency.h"
+#include "HammingMetrics.h"
+#include "HammingProfile.h"
+#include "HammingTrace.h"
+
+
+//PackedEncode class constructor
+PackedEncode::PackedEncode(std::string file, std::uint32_t chunkSize, bool withCrc)
+    : Hamming(file), chunkSize(chunkSize ? chunkSize : defaultChunkSize), withCrc(withCrc) {
+    processFile();
+}
+PackedEncode::~PackedEncode() {}
+
+
+void PackedEncode::processFile() {
+    std::ifstream inputFile(fileName, std::ios::in | std::ios::binary);
+    if (!inputFile.is_open()) {
+        std::cerr << "Error opening file: " << fileName << std::endl;
+        return;
+    }
+
+    std::string outFileName = fileName.substr(0, fileName.find_last_of('.')) + ".hmc";
+    std::ofstream outputFile(outFileName, std::ios::out | std::ios::binary | std::ios::trunc);
+    if (!outputFile.is_open()) {
+        std::cerr << "Error creating output file" << std::endl;
+        return;
+    }
+
+    //The header is rewritten once the total size is known
+    ContainerHeader header = {};
+    std::memcpy(header.magic, containerMagic, 4);
+    header.version = 1;
+    header.flags = withCrc ? containerFlagCrc : 0;
+    header.chunkSize = chunkSize;
+    outputFile.write(reinterpret_cast<const char*>(&header), sizeof(header));
+
+    std::vector<ChunkIndexEntry> index;
+    std::vector<char> plain(chunkSize);
+    std::vector<unsigned char> encoded(static_cast<std::size_t>(chunkSize) * containerBytesPerByte);
+    std::uint64_t offset = sizeof(header);
+
+    //One index entry per chunk, reserved from the input size so the index does not regrow
+    inputFile.seekg(0, std::ios::end);
+    std::streamoff inputSize = inputFile.tellg();
+    inputFile.seekg(0, std::ios::beg);
+    if (inputSize > 0) index.reserve(static_cast<std::size_t>(inputSize) / chunkSize + 1);
+
+    while (inputFile) {
+        std::size_t n;
+        {
+            HAMMING_PROFILE_SCOPE(Read);
+            TraceScope trace("read", index.size());
+            LatencyScope latency(LatencyOp::Read);
+            inputFile.read(plain.data(), chunkSize);
+            n = static_cast<std::size_t>(inputFile.gcount());
+        }
+        if (n == 0) break;
+
+        ChunkIndexEntry entry;
+        {
+            HAMMING_PROFILE_SCOPE(Kernel);
+            TraceScope trace("encode", index.size());
+            LatencyScope latency(LatencyOp::Encode);
+            for (std::size_t i = 0; i < n; ++i) {
+                unsigned char ch = static_cast<unsigned char>(plain[i]);
+                encoded[2 * i] = encodeTable[ch >> 4];        //Higher 4 bits
+                encoded[2 * i + 1] = encodeTable[ch & 0x0F];  //Lower 4 bits
+            }
+            entry.offset = offset;
+            entry.length = static_cast<std::uint32_t>(n);
+            entry.crc = withCrc ? crc32c(plain.data(), n) : 0;
+        }
+        Metrics::count(n, n * containerBytesPerByte, n * containerBytesPerByte);
+        {
+            HAMMING_PROFILE_SCOPE(Write);
+            TraceScope trace("write", index.size());
+            LatencyScope latency(LatencyOp::Write);
+            outputFile.write(reinterpret_cast<const char*>(encoded.data()), n * containerBytesPerByte);
+        }
+        index.push_back(entry);
+
+        offset += n * containerBytesPerByte;
+        header.dataSize += n;
+    }
+
+    //Trailer: chunk index followed by the footer that locates it
+    ContainerFooter footer = {};
+    footer.indexOffset = offset;
+    footer.chunkCount = static_cast<std::uint32_t>(index.size());
+    std::memcpy(footer.magic, containerIndexMagic, 4);
+    outputFile.write(reinterpret_cast<const char*>(index.data()), index.size() * sizeof(ChunkIndexEntry));
+    outputFile.write(reinterpret_cast<const char*>(&footer), sizeof(footer));
+
+    outputFile.seekp(0);
+    outputFile.write(reinterpret_cast<const char*>(&header), sizeof(header));
+
+    if (!outputFile) {
+        std::cerr << "Error writing output file: " << outFileName << std::endl;
+        return;
+    }
+    std::cout << "Packed encoding complete. " << header.dataSize << " bytes in " << index.size()
+              << " chunks written to " << outFileName << ".\n";
+}
+
+
+//PackedDecode class constructor
+PackedDecode::PackedDecode(std::string file) : Hamming(file) {
+    processFile();
+}
+PackedDecode::~PackedDecode() {}
+
+
+void PackedDecode::processFile() {
+    failedChunks.clear();
+    stats = DecodeStats();
+
+    int fd = open(fileName.c_str(), O_RDONLY);
+    if (fd < 0) {
+        std::cerr << "Error opening file: " << fileName << std::endl;
+        return;
+    }
+
+    ContainerHeader header;
+    std::vector<ChunkIndexEntry> index;
+    if (!readContainerIndex(fd, header, index)) {
+        std::cerr << "Error: " << fileName << " is not a valid packed container." << std::endl;
+        close(fd);
+        return;
+    }
+
+    std::string outFileName = fileName.substr(0, fileName.find_last_of('.')) + "_decoded.txt";
+    std::ofstream outFile(outFileName, std::ios::out | std::ios::binary | std::ios::trunc);
+    if (!outFile.is_open()) {
+        std::cerr << "Error opening file: " << outFileName << std::endl;
+        close(fd);
+        return;
+    }
+
+    std::vector<unsigned char> encoded;
+    std::vector<char> plain;
+
+    for (std::size_t c = 0; c < index.size(); ++c) {
+        const ChunkIndexEntry& entry = index[c];
+        encoded.resize(static_cast<std::size_t>(entry.length) * containerBytesPerByte);
+        plain.resize(entry.length);
+
+        ssize_t got;
+        {
+            HAMMING_PROFILE_SCOPE(Read);
+            TraceScope trace("read", c);
+            LatencyScope latency(LatencyOp::Read);
+            got = pread(fd, encoded.data(), encoded.size(), static_cast<off_t>(entry.offset));
+        }
+        if (got != static_cast<ssize_t>(encoded.size())) {
+            std::cerr << "Error: Chunk " << c << " is truncated." << std::endl;
+            failedChunks.push_back(c);
+            continue;
+        }
+
+        bool crcFailed;
+        std::size_t correctedBefore = stats.corrected;
+        {
+            HAMMING_PROFILE_SCOPE(Kernel);
+            TraceScope trace("decode", c);
+            LatencyScope latency(LatencyOp::Decode);
+            for (std::size_t i = 0; i < entry.length; ++i) {
+                unsigned char high = encoded[2 * i] & 0x7F;
+                unsigned char low = encoded[2 * i + 1] & 0x7F;
+                stats.record(syndromeTable[high]);
+                stats.record(syndromeTable[low]);
+                plain[i] = static_cast<char>((correctTable[high] << 4) | correctTable[low]);
+            }
+            crcFailed = (header.flags & containerFlagCrc) && crc32c(plain.data(), plain.size()) != entry.crc;
+        }
+
+        if (crcFailed) {
+            std::cerr << "Error: Chunk " << c << " failed its CRC32C check (uncorrectable errors)." << std::endl;
+            failedChunks.push_back(c);
+            stats.uncorrectable += encoded.size();
+        }
+        Metrics::count(encoded.size(), plain.size(), encoded.size(), stats.corrected - correctedBefore, crcFailed ? encoded.size() : 0);
+
+        //Failed chunks are still written so offsets line up; callers re-fetch them by index
+        HAMMING_PROFILE_SCOPE(Write);
+        TraceScope trace("write", c);
+        LatencyScope latency(LatencyOp::Write);
+        outFile.write(plain.data(), plain.size());
+    }
+    close(fd);
+    outFile.close();
+
+    std::cout << "Decoding complete. ";
+    stats.print(std::cout);
+    std::cout << " " << failedChunks.size() << " of " << index.size() << " chunks failed. Output written to " << outFileName << ".\n";
+}
+
+//Getter method
+const std::vector<std::size_t>& PackedDecode::getFailedChunks() const {
+    return failedChunks;
+}
+
+const DecodeStats& PackedDecode::getStats() const {
+    return stats;
+}
+
+
+//Helper function
+bool isContainer(const std::string& file) {
+    std::ifstream inputFile(file, std::ios::in | std::ios::binary);
+    char magic[4] = {};
+    inputFile.read(magic, 4);
+    return inputFile.gcount() == 4 && std::memcmp(magic, containerMagic, 4) == 0;
+}
+
+//Reads the header, then the footer at the end of the file, then the index it points to
+bool readContainerIndex(int fd, ContainerHeader& header, std::vector<ChunkIndexEntry>& index) {
+    struct stat st;
+    if (fstat(fd, &st) != 0) return false;
+    std::uint64_t fileSize = static_cast<std::uint64_t>(st.st_size);
+    if (fileSize < sizeof(ContainerHeader) + sizeof(ContainerFooter)) return false;
+
+    if (pread(fd, &header, sizeof(header), 0) != static_cast<ssize_t>(sizeof(header))) return false;
+    if (std::memcmp(header.magic, containerMagic, 4) != 0 || header.version != 1 || header.chunkSize == 0) return false;
+
+    ContainerFooter footer;
+    off_t footerOffset = static_cast<off_t>(fileSize - sizeof(footer));
+    if (pread(fd, &footer, sizeof(footer), footerOffset) != static_cast<ssize_t>(sizeof(footer))) return false;
+    if (std::memcmp(footer.magic, containerIndexMagic, 4) != 0) return false;
+
+    std::uint64_t indexBytes = static_cast<std::uint64_t>(footer.chunkCount) * sizeof(ChunkIndexEntry);
+    if (footer.indexOffset + indexBytes + sizeof(footer) != fileSize) return false;
+
+    index.resize(footer.chunkCount);
+    if (indexBytes && pread(fd, index.data(), indexBytes, static_cast<off_t>(footer.indexOffset)) != static_cast<ssize_t>(indexBytes)) return false;
+
+    //Every chunk but the last holds exactly chunkSize bytes and together they hold dataSize bytes,
+    //so readers can find the chunk of any offset by division
+    std::uint64_t total = 0;
+    for (std::size_t c = 0; c < index.size(); ++c) {
+        const ChunkIndexEntry& entry = index[c];
+        if (entry.length == 0 || entry.length > header.chunkSize) return false;
+        if (c + 1 < index.size() && entry.length != header.chunkSize) return false;
+        if (entry.offset + static_cast<std::uint64_t>(entry.length) * containerBytesPerByte > footer.indexOffset) return false;
+        total += entry.length;
+    }
+    return total == header.dataSize;
+}
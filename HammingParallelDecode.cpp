@@ -0,0 +1,162 @@
+// Multi-threaded text decoder
+// The input is cut into byte ranges; each range moves forward to the next record boundary (newline)
+// Ranges decode into their own buffers and count corrections into their own DecodeStats
+// A prefix sum over the decoded lengths gives every range its output offset, since malformed
+// lines produce no output, and the buffers are then written in place with pwrite()
+
+#include <iostream>
+#include <string>
+#include <vector>
+#include <atomic>
+#include <memory>
+#include <algorithm>
+#include <cstring>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include "Hamming.h"
+#include "HammingLatency.h"
+#include "HammingProfile.h"
+#include "HammingTrace.h"
+#include "ThreadPool.h"
+
+
+//ParallelDecode class constructor
+ParallelDecode::ParallelDecode(std::string file, unsigned threads, std::size_t chunkSize)
+    : Hamming(file), threads(ThreadPool::resolveThreads(threads)), chunkSize(chunkSize ? chunkSize : defaultChunkSize), sharedPool(nullptr) {
+    processFile();
+}
+ParallelDecode::ParallelDecode(std::string file, ThreadPool& pool, std::size_t chunkSize)
+    : Hamming(file), threads(pool.size()), chunkSize(chunkSize ? chunkSize : defaultChunkSize), sharedPool(&pool) {
+    processFile();
+}
+ParallelDecode::~ParallelDecode() {}
+
+
+//Start of the first record at or after a nominal split point
+static std::size_t recordBoundary(const char* data, std::size_t size, std::size_t pos) {
+    if (pos == 0 || pos >= size) return std::min(pos, size);
+    if (data[pos - 1] == '\n') return pos;
+    const void* newline = std::memchr(data + pos, '\n', size - pos);
+    return newline ? static_cast<std::size_t>(static_cast<const char*>(newline) - data) + 1 : size;
+}
+
+
+void ParallelDecode::processFile() {
+    stats = DecodeStats();
+
+    int inFd = open(fileName.c_str(), O_RDONLY);
+    if (inFd < 0) {
+        std::cerr << "Error opening file: " << fileName << std::endl;
+        return;
+    }
+
+    struct stat st;
+    if (fstat(inFd, &st) != 0) {
+        std::cerr << "Error reading size of file: " << fileName << std::endl;
+        close(inFd);
+        return;
+    }
+    std::size_t size = static_cast<std::size_t>(st.st_size);
+
+    std::string outFileName = fileName.substr(0, fileName.find_last_of('.')) + "_decoded.txt";
+    int outFd = open(outFileName.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+    if (outFd < 0) {
+        std::cerr << "Error opening file: " << outFileName << std::endl;
+        close(inFd);
+        return;
+    }
+
+    const char* data = nullptr;
+    if (size > 0) {
+        void* mapping = mmap(nullptr, size, PROT_READ, MAP_PRIVATE, inFd, 0);
+        if (mapping == MAP_FAILED) {
+            std::cerr << "Error mapping file: " << fileName << std::endl;
+            close(inFd);
+            close(outFd);
+            return;
+        }
+        madvise(mapping, size, MADV_SEQUENTIAL);
+        data = static_cast<const char*>(mapping);
+    }
+
+    //Ranges are handled a window at a time so buffered output stays bounded; the window's buffers
+    //are reserved for the largest range up front, so runs allocate the same whatever the file size
+    std::size_t chunks = (size + chunkSize - 1) / chunkSize;
+    std::size_t window = static_cast<std::size_t>(threads) * 4;
+    std::vector<std::vector<char>> decoded(window);
+    for (std::vector<char>& buffer : decoded) buffer.reserve(std::min(size, chunkSize + 14) / 14 + 1);
+    std::vector<DecodeStats> rangeStats(window);
+    std::vector<std::size_t> rangeOffset(window);
+    std::atomic<bool> failed(false);
+    std::size_t outOffset = 0;
+    std::size_t first = 0;
+
+    //Decode range first + k into its own buffer
+    auto decodeRange = [&](std::size_t k) {
+        std::size_t c = first + k;
+        HAMMING_PROFILE_SCOPE(Kernel);
+        TraceScope trace("decode", c);
+        std::size_t begin = recordBoundary(data, size, c * chunkSize);
+        std::size_t end = recordBoundary(data, size, (c + 1) * chunkSize);
+        rangeStats[k] = DecodeStats();
+        decoded[k].resize(end > begin ? (end - begin) / 14 + 1 : 0);
+        decoded[k].resize(decodeFromText(data + begin, end > begin ? end - begin : 0, decoded[k].data(), rangeStats[k]));
+    };
+
+    //Write the buffer of range first + k at its offset
+    auto writeRange = [&](std::size_t k) {
+        HAMMING_PROFILE_SCOPE(Write);
+        TraceScope trace("write", first + k);
+        LatencyScope latency(LatencyOp::Write);
+        std::size_t done = 0;
+        while (done < decoded[k].size()) {
+            ssize_t n = pwrite(outFd, decoded[k].data() + done, decoded[k].size() - done, static_cast<off_t>(rangeOffset[k] + done));
+            if (n <= 0) {
+                failed = true;
+                return;
+            }
+            done += static_cast<std::size_t>(n);
+        }
+    };
+
+    {
+        std::unique_ptr<ThreadPool> ownPool;
+        if (!sharedPool) ownPool = std::make_unique<ThreadPool>(threads);
+        ThreadPool& pool = sharedPool ? *sharedPool : *ownPool;
+        ThreadPool::Group group;
+
+        //Tasks capture a reference and an index, small enough for std::function to hold without allocating
+        for (first = 0; first < chunks; first += window) {
+            std::size_t count = std::min(window, chunks - first);
+
+            for (std::size_t k = 0; k < count; ++k) pool.submit(group, [&decodeRange, k] { decodeRange(k); });
+            pool.wait(group);
+
+            //Prefix sum over the decoded lengths, then write every range at its offset
+            for (std::size_t k = 0; k < count; ++k) {
+                rangeOffset[k] = outOffset;
+                outOffset += decoded[k].size();
+                stats.merge(rangeStats[k]);
+                pool.submit(group, [&writeRange, k] { writeRange(k); });
+            }
+            pool.wait(group);
+        }
+    }
+
+    if (data) munmap(const_cast<char*>(data), size);
+    close(inFd);
+    if (close(outFd) != 0 || failed) {
+        std::cerr << "Error writing output file: " << outFileName << std::endl;
+        return;
+    }
+    std::cout << "Parallel decoding complete (" << threads << " threads): ";
+    stats.print(std::cout);
+    std::cout << " Output written to " << outFileName << ".\n";
+}
+
+//Getter method
+const DecodeStats& ParallelDecode::getStats() const {
+    return stats;
+}
@@ -0,0 +1,149 @@
+// Multi-threaded text encoder
+// Pass 1 counts the newlines of every chunk; a prefix sum turns that into each chunk's output offset
+// Pass 2 encodes the chunks independently and writes them at their final offsets with pwrite()
+// Both passes run a window of chunks at a time, since pass 2 only needs the offsets before it
+// Output is byte-identical to Encode's _out.txt, so nothing ever needs reordering
+
+#include <iostream>
+#include <string>
+#include <vector>
+#include <atomic>
+#include <memory>
+#include <algorithm>
+#include <cstring>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include "Hamming.h"
+#include "HammingLatency.h"
+#include "HammingProfile.h"
+#include "HammingTrace.h"
+#include "ThreadPool.h"
+
+namespace {
+    const std::size_t pieceSize = 64 << 10;  //Input bytes encoded per write
+}
+
+
+//ParallelEncode class constructor
+ParallelEncode::ParallelEncode(std::string file, unsigned threads, std::size_t chunkSize)
+    : Hamming(file), threads(ThreadPool::resolveThreads(threads)), chunkSize(chunkSize ? chunkSize : defaultChunkSize), sharedPool(nullptr) {
+    processFile();
+}
+ParallelEncode::ParallelEncode(std::string file, ThreadPool& pool, std::size_t chunkSize)
+    : Hamming(file), threads(pool.size()), chunkSize(chunkSize ? chunkSize : defaultChunkSize), sharedPool(&pool) {
+    processFile();
+}
+ParallelEncode::~ParallelEncode() {}
+
+
+void ParallelEncode::processFile() {
+    int inFd = open(fileName.c_str(), O_RDONLY);
+    if (inFd < 0) {
+        std::cerr << "Error opening file: " << fileName << std::endl;
+        return;
+    }
+
+    struct stat st;
+    if (fstat(inFd, &st) != 0) {
+        std::cerr << "Error reading size of file: " << fileName << std::endl;
+        close(inFd);
+        return;
+    }
+    std::size_t size = static_cast<std::size_t>(st.st_size);
+
+    std::string outFileName = fileName.substr(0, fileName.find_last_of('.')) + "_out.txt";
+    int outFd = open(outFileName.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+    if (outFd < 0) {
+        std::cerr << "Error creating output file" << std::endl;
+        close(inFd);
+        return;
+    }
+
+    const char* data = nullptr;
+    if (size > 0) {
+        void* mapping = mmap(nullptr, size, PROT_READ, MAP_PRIVATE, inFd, 0);
+        if (mapping == MAP_FAILED) {
+            std::cerr << "Error mapping file: " << fileName << std::endl;
+            close(inFd);
+            close(outFd);
+            return;
+        }
+        data = static_cast<const char*>(mapping);
+    }
+
+    std::size_t chunks = (size + chunkSize - 1) / chunkSize;
+    std::vector<std::size_t> outOffset(chunks + 1, 0);
+    std::atomic<bool> failed(false);
+
+    //Pass 1: records of chunk c (every byte but '\n')
+    auto countRecords = [&](std::size_t c) {
+        HAMMING_PROFILE_SCOPE(Parse);
+        TraceScope trace("parse", c);
+        const char* begin = data + c * chunkSize;
+        const char* end = data + std::min(size, (c + 1) * chunkSize);
+        outOffset[c + 1] = static_cast<std::size_t>(end - begin) - static_cast<std::size_t>(std::count(begin, end, '\n'));
+    };
+
+    //Pass 2: encode chunk c a piece at a time into its window slot's buffer and write each piece at
+    //its final offset; the buffers are allocated once per run, whichever threads run the tasks
+    std::size_t window = static_cast<std::size_t>(threads) * 4;
+    std::vector<std::vector<char>> encoded(window);
+    for (std::vector<char>& buffer : encoded) buffer.resize(std::min(size, pieceSize) * 15);
+    auto encodeChunk = [&](std::size_t c) {
+        std::vector<char>& buffer = encoded[c % window];
+        std::size_t end = std::min(size, (c + 1) * chunkSize);
+        std::size_t at = outOffset[c];
+        for (std::size_t piece = c * chunkSize; piece < end; piece += pieceSize) {
+            std::size_t written;
+            {
+                HAMMING_PROFILE_SCOPE(Kernel);
+                TraceScope trace("encode", c);
+                written = encodeToText(data + piece, std::min(pieceSize, end - piece), buffer.data());
+            }
+            HAMMING_PROFILE_SCOPE(Write);
+            TraceScope trace("write", c);
+            LatencyScope latency(LatencyOp::Write);
+            std::size_t done = 0;
+            while (done < written) {
+                ssize_t n = pwrite(outFd, buffer.data() + done, written - done, static_cast<off_t>(at + done));
+                if (n <= 0) {
+                    failed = true;
+                    return;
+                }
+                done += static_cast<std::size_t>(n);
+            }
+            at += written;
+        }
+    };
+
+    {
+        std::unique_ptr<ThreadPool> ownPool;
+        if (!sharedPool) ownPool = std::make_unique<ThreadPool>(threads);
+        ThreadPool& pool = sharedPool ? *sharedPool : *ownPool;
+        ThreadPool::Group group;
+
+        //Chunks go through both passes a window at a time, so the pool's queues stay short; tasks
+        //capture a reference and an index, small enough for std::function to hold without allocating
+        for (std::size_t first = 0; first < chunks; first += window) {
+            std::size_t last = std::min(chunks, first + window);
+            for (std::size_t c = first; c < last; ++c) pool.submit(group, [&countRecords, c] { countRecords(c); });
+            pool.wait(group);
+
+            //Prefix sum: record counts -> byte offsets in the output
+            for (std::size_t c = first; c < last; ++c) outOffset[c + 1] = outOffset[c] + outOffset[c + 1] * 15;
+
+            for (std::size_t c = first; c < last; ++c) pool.submit(group, [&encodeChunk, c] { encodeChunk(c); });
+            pool.wait(group);
+        }
+    }
+
+    if (data) munmap(const_cast<char*>(data), size);
+    close(inFd);
+    if (close(outFd) != 0 || failed) {
+        std::cerr << "Error writing output file: " << outFileName << std::endl;
+        return;
+    }
+    std::cout << "Parallel encoding complete (" << threads << " threads, " << chunks << " chunks). Output written to " + outFileName + ".\n";
+}
@@ -0,0 +1,243 @@
+// Streaming reader -> codec -> writer pipeline
+// Chunk i is handled by lane i % codecThreads; every lane owns preallocated chunk buffers and
+// three lock-free SPSC rings of buffer indices: free (writer -> reader), filled (reader -> codec)
+// and done (codec -> writer). The writer visits lanes round-robin, so output stays in order
+// without a reorder buffer, and an empty free ring is what makes the reader wait for the writer
+
+#include <iostream>
+#include <string>
+#include <vector>
+#include <memory>
+#include <thread>
+#include <atomic>
+#include <cstdint>
+#include <cstring>
+#include <algorithm>
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include "Hamming.h"
+#include "RingBuffer.h"
+#include "HammingLatency.h"
+#include "HammingMetrics.h"
+#include "HammingProfile.h"
+#include "HammingTrace.h"
+#include "ThreadPool.h"
+
+namespace {
+    const std::uint32_t endMarker = UINT32_MAX; //Sent through the rings after the last chunk
+
+    //One chunk buffer, reused for the whole run
+    struct Chunk {
+        std::vector<char> in;        //Input bytes
+        std::size_t inLength = 0;    //Valid input bytes
+        std::vector<char> out;       //Encoded or decoded bytes
+        std::size_t outLength = 0;   //Valid output bytes
+        std::size_t seq = 0;         //Position of the chunk in the input
+    };
+
+    //Buffers and rings of one codec thread
+    struct Lane {
+        std::vector<Chunk> chunks;
+        SpscRing<std::uint32_t> free;
+        SpscRing<std::uint32_t> filled;
+        SpscRing<std::uint32_t> done;
+        DecodeStats stats;
+
+        Lane(std::size_t slots) : chunks(slots), free(slots), filled(slots + 1), done(slots + 1) {
+            for (std::uint32_t i = 0; i < slots; ++i) free.push(i);
+        }
+    };
+
+    //Only grows, so steady state never allocates
+    void ensureSize(std::vector<char>& buffer, std::size_t size) {
+        if (buffer.size() < size) buffer.resize(size);
+    }
+}
+
+
+//Pipeline class constructor
+Pipeline::Pipeline(std::string file, Mode mode, unsigned codecThreads, std::size_t chunkSize)
+    : Hamming(file), mode(mode), codecThreads(ThreadPool::resolveThreads(codecThreads)), chunkSize(chunkSize ? chunkSize : defaultChunkSize) {
+    processFile();
+}
+Pipeline::~Pipeline() {}
+
+
+void Pipeline::processFile() {
+    stats = DecodeStats();
+
+    int inFd = open(fileName.c_str(), O_RDONLY);
+    if (inFd < 0) {
+        std::cerr << "Error opening file: " << fileName << std::endl;
+        return;
+    }
+
+    std::string suffix = mode == Mode::Encode ? "_out.txt" : "_decoded.txt";
+    std::string outFileName = fileName.substr(0, fileName.find_last_of('.')) + suffix;
+    int outFd = open(outFileName.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+    if (outFd < 0) {
+        std::cerr << "Error creating output file" << std::endl;
+        close(inFd);
+        return;
+    }
+
+    //Preallocate every buffer up front, but no more lanes or slots than the input has chunks
+    //(a decode chunk may spill one record into an extra chunk); unknown sizes (pipes) get the maximum
+    std::size_t laneCount = codecThreads, slotCount = defaultSlots;
+    struct stat st;
+    if (fstat(inFd, &st) == 0 && S_ISREG(st.st_mode)) {
+        std::size_t chunks = static_cast<std::size_t>(st.st_size) / chunkSize + 1;
+        laneCount = std::min(laneCount, chunks);
+        slotCount = std::min(slotCount, (chunks + laneCount - 1) / laneCount);
+    }
+    std::size_t outPerChunk = mode == Mode::Encode ? chunkSize * 15 : chunkSize / 14 + 1;
+    std::vector<std::unique_ptr<Lane>> lanes;
+    for (std::size_t k = 0; k < laneCount; ++k) {
+        lanes.push_back(std::make_unique<Lane>(slotCount));
+        for (Chunk& chunk : lanes.back()->chunks) {
+            chunk.in.resize(chunkSize);
+            chunk.out.resize(outPerChunk);
+        }
+    }
+
+    std::atomic<bool> readFailed(false);
+    std::atomic<bool> writeFailed(false);
+
+    //Reader: fills chunks in sequence; decode chunks end on a record boundary
+    std::thread reader([&] {
+        Trace::nameThread("reader");
+        std::vector<char> carry;
+        std::size_t seq = 0;
+        bool eof = false;
+        while (!eof) {
+            Lane& lane = *lanes[seq % lanes.size()];
+            std::uint32_t slot;
+            {
+                TraceScope trace("wait for writer", seq);
+                slot = lane.free.pop();
+            }
+            Chunk& chunk = lane.chunks[slot];
+
+            ensureSize(chunk.in, carry.size() + chunkSize);
+            std::memcpy(chunk.in.data(), carry.data(), carry.size());
+            std::size_t length = carry.size();
+            std::size_t target = length + chunkSize;
+            carry.clear();
+
+            {
+                HAMMING_PROFILE_SCOPE(Read);
+                TraceScope trace("read", seq);
+                LatencyScope latency(LatencyOp::Read);
+                while (length < target) {
+                    ssize_t n = read(inFd, chunk.in.data() + length, target - length);
+                    if (n <= 0) {
+                        if (n < 0) readFailed = true;
+                        eof = true;
+                        break;
+                    }
+                    length += static_cast<std::size_t>(n);
+                }
+            }
+
+            if (mode == Mode::Decode && !eof) {
+                std::size_t keep = length;
+                while (keep > 0 && chunk.in[keep - 1] != '\n') --keep;
+                carry.assign(chunk.in.data() + keep, chunk.in.data() + length);
+                length = keep;
+            }
+
+            chunk.inLength = length;
+            chunk.seq = seq;
+            Metrics::queue(MetricQueue::PipelineCodec, 1);
+            lane.filled.push(slot);
+            ++seq;
+        }
+
+        for (std::size_t k = 0; k < lanes.size(); ++k) lanes[(seq + k) % lanes.size()]->filled.push(endMarker);
+    });
+
+    //Codecs: one per lane
+    std::vector<std::thread> codecs;
+    for (std::size_t k = 0; k < lanes.size(); ++k) {
+        codecs.emplace_back([&, k] {
+            Trace::nameThread("codec " + std::to_string(k + 1));
+            Lane& lane = *lanes[k];
+            for (;;) {
+                std::uint32_t slot;
+                {
+                    TraceScope trace("wait for reader");
+                    slot = lane.filled.pop();
+                }
+                if (slot == endMarker) {
+                    lane.done.push(endMarker);
+                    return;
+                }
+
+                Metrics::queue(MetricQueue::PipelineCodec, -1);
+                Chunk& chunk = lane.chunks[slot];
+                HAMMING_PROFILE_SCOPE(Kernel);
+                TraceScope trace(mode == Mode::Encode ? "encode" : "decode", chunk.seq);
+                if (mode == Mode::Encode) {
+                    ensureSize(chunk.out, chunk.inLength * 15);
+                    chunk.outLength = encodeToText(chunk.in.data(), chunk.inLength, chunk.out.data());
+                } else {
+                    ensureSize(chunk.out, chunk.inLength / 14 + 1);
+                    chunk.outLength = decodeFromText(chunk.in.data(), chunk.inLength, chunk.out.data(), lane.stats);
+                }
+                Metrics::queue(MetricQueue::PipelineWriter, 1);
+                lane.done.push(slot);
+            }
+        });
+    }
+
+    //Writer: visits lanes in sequence order and hands buffers back to the reader
+    std::thread writer([&] {
+        Trace::nameThread("writer");
+        for (std::size_t seq = 0;; ++seq) {
+            Lane& lane = *lanes[seq % lanes.size()];
+            std::uint32_t slot;
+            {
+                TraceScope trace("wait for codec", seq);
+                slot = lane.done.pop();
+            }
+            if (slot == endMarker) return;
+            Metrics::queue(MetricQueue::PipelineWriter, -1);
+
+            Chunk& chunk = lane.chunks[slot];
+            HAMMING_PROFILE_SCOPE(Write);
+            TraceScope trace("write", seq);
+            LatencyScope latency(LatencyOp::Write);
+            std::size_t done = 0;
+            while (!writeFailed && done < chunk.outLength) {
+                ssize_t n = write(outFd, chunk.out.data() + done, chunk.outLength - done);
+                if (n <= 0) writeFailed = true;
+                else done += static_cast<std::size_t>(n);
+            }
+            lane.free.push(slot);
+        }
+    });
+
+    reader.join();
+    for (std::thread& codec : codecs) codec.join();
+    writer.join();
+
+    for (const auto& lane : lanes) stats.merge(lane->stats);
+    close(inFd);
+    if (close(outFd) != 0 || writeFailed || readFailed) {
+        std::cerr << "Error: Pipeline failed for " << fileName << std::endl;
+        return;
+    }
+
+    std::cout << (mode == Mode::Encode ? "Pipeline encoding" : "Pipeline decoding") << " complete (" << lanes.size() << " codec threads). ";
+    if (mode == Mode::Decode) {
+        stats.print(std::cout);
+        std::cout << " ";
+    }
+    std::cout << "Output written to " << outFileName << ".\n";
+}
+
+//Getter method
+const DecodeStats& Pipeline::getStats() const {
+    return stats;
+}
@@ -0,0 +1,229 @@
+// Optional hot-path instrumentation (see HammingProfile.h); empty unless built with HAMMING_PROFILE
+// Every thread owns its stage totals and a perf_event_open counter group that one read() samples,
+// so scopes never share a cache line or a lock; the SIGUSR1 handler only writes a byte to a pipe
+// and a helper thread prints the summary
+
+#ifdef HAMMING_PROFILE
+
+#include <iostream>
+#include <iomanip>
+#include <sstream>
+#include <atomic>
+#include <chrono>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+#include <cstdlib>
+#include <cstring>
+#include <csignal>
+#include <unistd.h>
+#include <sys/syscall.h>
+#include <linux/perf_event.h>
+#include "HammingProfile.h"
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#endif
+
+namespace {
+    const int stageCount = static_cast<int>(ProfileStage::Count);
+    const char* const stageNames[stageCount] = {"read", "parse", "kernel", "inject", "write"};
+    const std::uint64_t counterConfigs[Profile::counterCount] = {
+        PERF_COUNT_HW_CPU_CYCLES, PERF_COUNT_HW_INSTRUCTIONS, PERF_COUNT_HW_CACHE_MISSES, PERF_COUNT_HW_BRANCH_MISSES};
+
+    std::uint64_t ticks() {
+#if defined(__x86_64__) || defined(__i386__)
+        return __rdtsc();
+#else
+        return static_cast<std::uint64_t>(std::chrono::steady_clock::now().time_since_epoch().count());
+#endif
+    }
+
+    //Only the owning thread writes, so a relaxed load and store is enough and print() may read at any time
+    void add(std::atomic<std::uint64_t>& total, std::uint64_t value) {
+        total.store(total.load(std::memory_order_relaxed) + value, std::memory_order_relaxed);
+    }
+
+    struct StageTotals {
+        std::atomic<std::uint64_t> calls{0};
+        std::atomic<std::uint64_t> ticks{0};
+        std::atomic<std::uint64_t> counters[Profile::counterCount];
+    };
+
+    struct ThreadTotals {
+        std::size_t number = 0;       //Order of the thread's first scope
+        long tid = 0;                 //Kernel thread id
+        bool hardware = false;        //Whether the counter group opened
+        StageTotals stages[stageCount];
+    };
+
+    //The calling thread's totals and counter group; the group is closed when the thread exits
+    class ThreadState {
+        public:
+            ThreadState();
+            ~ThreadState();
+            bool read(std::uint64_t counters[Profile::counterCount]) const;
+            std::shared_ptr<ThreadTotals> totals;
+        private:
+            int fds[Profile::counterCount];
+    };
+
+    std::mutex registryMutex;
+    std::vector<std::shared_ptr<ThreadTotals>> registry;  //Every thread that opened a scope, exited ones included
+    int signalPipe[2] = {-1, -1};
+
+    void onSignal(int) {
+        char byte = 0;
+        ssize_t n = write(signalPipe[1], &byte, 1);
+        (void)n;
+    }
+
+    void printAtExit() {
+        Profile::print(std::cerr);
+    }
+
+    //Installed by the first scope of the process
+    void installReporters() {
+        std::atexit(printAtExit);
+        if (pipe(signalPipe) != 0) return;
+        std::thread([] {
+            char byte;
+            while (read(signalPipe[0], &byte, 1) == 1) Profile::print(std::cerr);
+        }).detach();
+
+        struct sigaction action = {};
+        action.sa_handler = onSignal;
+        sigemptyset(&action.sa_mask);
+        action.sa_flags = SA_RESTART;
+        sigaction(SIGUSR1, &action, nullptr);
+    }
+
+    ThreadState::ThreadState() : totals(std::make_shared<ThreadTotals>()) {
+        static std::once_flag once;
+        std::call_once(once, installReporters);
+
+        //One group per thread (pid 0, any cpu): user-space events only, read together
+        for (int k = 0; k < Profile::counterCount; ++k) fds[k] = -1;
+        for (int k = 0; k < Profile::counterCount; ++k) {
+            perf_event_attr attr;
+            std::memset(&attr, 0, sizeof(attr));
+            attr.size = sizeof(attr);
+            attr.type = PERF_TYPE_HARDWARE;
+            attr.config = counterConfigs[k];
+            attr.exclude_kernel = 1;
+            attr.exclude_hv = 1;
+            attr.read_format = PERF_FORMAT_GROUP;
+            fds[k] = static_cast<int>(syscall(SYS_perf_event_open, &attr, 0, -1, k == 0 ? -1 : fds[0], 0));
+            if (fds[k] < 0) {
+                for (int j = 0; j < k; ++j) close(fds[j]);
+                for (int j = 0; j < Profile::counterCount; ++j) fds[j] = -1;
+                break;
+            }
+        }
+
+        totals->tid = static_cast<long>(syscall(SYS_gettid));
+        totals->hardware = fds[0] >= 0;
+        std::lock_guard<std::mutex> lock(registryMutex);
+        totals->number = registry.size() + 1;
+        registry.push_back(totals);
+    }
+
+    ThreadState::~ThreadState() {
+        for (int fd : fds) {
+            if (fd >= 0) close(fd);
+        }
+    }
+
+    bool ThreadState::read(std::uint64_t counters[Profile::counterCount]) const {
+        struct {
+            std::uint64_t count;
+            std::uint64_t values[Profile::counterCount];
+        } group;
+        if (fds[0] < 0 || ::read(fds[0], &group, sizeof(group)) != static_cast<ssize_t>(sizeof(group))) return false;
+        std::memcpy(counters, group.values, sizeof(group.values));
+        return true;
+    }
+
+    ThreadState& local() {
+        thread_local ThreadState state;
+        return state;
+    }
+
+    //One row: calls, Mticks and, with hardware counters, Mcycles, Minstr, IPC and the miss counts
+    void printRow(std::ostream& out, const char* name, const std::uint64_t values[2 + Profile::counterCount], bool hardware) {
+        out << "  " << std::left << std::setw(8) << name << std::right << std::setw(10) << values[0]
+            << std::fixed << std::setprecision(2) << std::setw(11) << values[1] / 1e6;
+        if (hardware) {
+            out << std::setw(11) << values[2] / 1e6 << std::setw(11) << values[3] / 1e6
+                << std::setw(7) << (values[2] ? static_cast<double>(values[3]) / static_cast<double>(values[2]) : 0.0)
+                << std::setw(13) << values[4] << std::setw(13) << values[5];
+        } else {
+            out << std::setw(11) << "-" << std::setw(11) << "-" << std::setw(7) << "-" << std::setw(13) << "-" << std::setw(13) << "-";
+        }
+        out << "\n" << std::defaultfloat;
+    }
+}
+
+
+void Profile::begin(Sample& sample) {
+    ThreadState& state = local();
+    if (!state.read(sample.counters)) std::memset(sample.counters, 0, sizeof(sample.counters));
+    sample.ticks = ticks();  //After the counter read, so its system call is not charged to the scope
+}
+
+void Profile::end(ProfileStage stage, const Sample& start) {
+    std::uint64_t now = ticks();
+    ThreadState& state = local();
+    StageTotals& totals = state.totals->stages[static_cast<int>(stage)];
+    add(totals.calls, 1);
+    add(totals.ticks, now - start.ticks);
+
+    std::uint64_t counters[counterCount];
+    if (state.read(counters)) {
+        for (int k = 0; k < counterCount; ++k) add(totals.counters[k], counters[k] - start.counters[k]);
+    }
+}
+
+void Profile::print(std::ostream& out) {
+    std::vector<std::shared_ptr<ThreadTotals>> threads;
+    {
+        std::lock_guard<std::mutex> lock(registryMutex);
+        threads = registry;
+    }
+
+    bool hardware = false;
+    for (const auto& thread : threads) hardware = hardware || thread->hardware;
+
+    //Built in one buffer so a SIGUSR1 report does not interleave with other output
+    std::ostringstream text;
+    text << "Profile of " << threads.size() << " threads (ticks: time stamp counter; counters: user-space, per thread"
+         << (hardware ? "" : ", unavailable") << ")\n"
+         << "  stage        calls     Mticks    Mcycles     Minstr    IPC  cache-miss  branch-miss\n";
+
+    std::uint64_t sums[stageCount][2 + counterCount] = {};
+    for (const auto& thread : threads) {
+        for (int s = 0; s < stageCount; ++s) {
+            const StageTotals& totals = thread->stages[s];
+            sums[s][0] += totals.calls.load(std::memory_order_relaxed);
+            sums[s][1] += totals.ticks.load(std::memory_order_relaxed);
+            for (int k = 0; k < counterCount; ++k) sums[s][2 + k] += totals.counters[k].load(std::memory_order_relaxed);
+        }
+    }
+    for (int s = 0; s < stageCount; ++s) {
+        if (sums[s][0]) printRow(text, stageNames[s], sums[s], hardware);
+    }
+
+    for (const auto& thread : threads) {
+        text << " thread " << thread->number << " (tid " << thread->tid << ")\n";
+        for (int s = 0; s < stageCount; ++s) {
+            const StageTotals& totals = thread->stages[s];
+            std::uint64_t values[2 + counterCount] = {totals.calls.load(std::memory_order_relaxed), totals.ticks.load(std::memory_order_relaxed)};
+            for (int k = 0; k < counterCount; ++k) values[2 + k] = totals.counters[k].load(std::memory_order_relaxed);
+            if (values[0]) printRow(text, stageNames[s], values, thread->hardware);
+        }
+    }
+    out << text.str() << std::flush;
+}
+
+#endif
@@ -0,0 +1,118 @@
+/* Colton Criswell and Zach Hamby
+ * Final Project - CS-300
+ */
+
+#ifndef HAMMING_PROFILE_H
+#define HAMMING_PROFILE_H
+
+/*
+ * Optional hot-path instrumentation, compiled in with -DHAMMING_PROFILE (make clean && make PROFILE=1).
+ *
+ * HAMMING_PROFILE_SCOPE(Stage) times the rest of the enclosing block as one of the stages below:
+ * time stamp counter ticks plus, where perf_event_open is allowed, the calling thread's cycles,
+ * instructions, cache misses and branch misses. Totals are kept per thread and per stage and are
+ * printed to std::cerr at exit and whenever the process receives SIGUSR1. Scopes cost two counter
+ * reads (a system call each), so they wrap chunks, never single records.
+ *
+ * Without HAMMING_PROFILE the macro expands to an empty statement and nothing else is compiled.
+ */
+
+#ifdef HAMMING_PROFILE
+
+#include <cstdint>
+#include <ostream>
+
+/**
+ * @brief Codec stages a profile scope can be charged to.
+ */
+enum class ProfileStage {
+    Read,   ///< Reading input (read, pread, stream reads)
+    Parse,  ///< Turning text records into codewords, or scanning input
+    Kernel, ///< Encoding, correcting and decoding
+    Inject, ///< Applying channel models, overlays and fault maps
+    Write,  ///< Formatting and writing output
+    Count   ///< Number of stages
+};
+
+/**
+ * @class Profile
+ * @brief Per-thread stage totals of the instrumentation layer.
+ *
+ * Every thread that opens a scope gets its own totals (and its own hardware counter group), so
+ * recording never contends; print() reads all of them with relaxed loads.
+ */
+class Profile {
+
+    public:
+        static const int counterCount = 4; ///< cycles, instructions, cache misses, branch misses
+
+        /**
+         * @struct Sample
+         * @brief Counter values at the start of a scope.
+         */
+        struct Sample {
+            std::uint64_t ticks;                  ///< Time stamp counter
+            std::uint64_t counters[counterCount]; ///< Hardware counters (zero if unavailable)
+        };
+
+        /**
+         * @brief Reads the calling thread's counters.
+         * @param sample Receives the values.
+         */
+        static void begin(Sample& sample);
+
+        /**
+         * @brief Charges the counters elapsed since a sample to a stage of the calling thread.
+         * @param stage The stage.
+         * @param start Values read by begin().
+         */
+        static void end(ProfileStage stage, const Sample& start);
+
+        /**
+         * @brief Prints the totals per stage over all threads, then per thread.
+         * @param out Destination stream.
+         */
+        static void print(std::ostream& out);
+};
+
+/**
+ * @class ProfileScope
+ * @brief Charges the lifetime of a block to a stage.
+ */
+class ProfileScope {
+
+    public:
+        /**
+         * @brief Constructor for ProfileScope class; starts the measurement.
+         * @param stage The stage to charge.
+         */
+        explicit ProfileScope(ProfileStage stage) : stage(stage) {
+            Profile::begin(start);
+        }
+
+        /**
+         * @brief Destructor for ProfileScope class; charges the elapsed counters.
+         */
+        ~ProfileScope() {
+            Profile::end(stage, start);
+        }
+
+        ProfileScope(const ProfileScope&) = delete;
+        ProfileScope& operator=(const ProfileScope&) = delete;
+
+    private:
+        ProfileStage stage;     ///< Stage to charge
+        Profile::Sample start;  ///< Counters at construction
+};
+
+#define HAMMING_PROFILE_JOIN2(a, b) a##b
+#define HAMMING_PROFILE_JOIN(a, b) HAMMING_PROFILE_JOIN2(a, b)
+#define HAMMING_PROFILE_SCOPE(stage) ProfileScope HAMMING_PROFILE_JOIN(profileScope, __LINE__)(ProfileStage::stage)
+
+#else
+
+#define HAMMING_PROFILE_SCOPE(stage) do {} while (0)
+
+#endif
+
+#endif
@@ -0,0 +1,93 @@
+/* Colton Criswell and Zach Hamby
+ * Final Project - CS-300
+ */
+
+#ifndef HAMMING_RANDOM_H
+#define HAMMING_RANDOM_H
+
+#include <array>
+#include <cstdint>
+
+/**
+ * @class Philox
+ * @brief Philox4x32-10 counter-based random number generator.
+ *
+ * Every output block is a pure function of (seed, counter): there is no hidden state, so any
+ * block of a stream can be computed directly, from any thread, in any order, and reproduced
+ * exactly. Error injection uses the codeword index as the counter.
+ */
+class Philox {
+
+    public:
+        using Block = std::array<std::uint32_t, 4>; ///< Four 32-bit outputs per counter value
+
+        /**
+         * @brief Constructor for Philox class.
+         * @param seed The 64-bit key.
+         * @param stream Independent stream number (e.g. one per thread or per channel).
+         */
+        explicit Philox(std::uint64_t seed, std::uint64_t stream = 0) : seed(seed), stream(stream) {}
+
+        /**
+         * @brief Computes the four outputs for one counter value.
+         * @param counter The counter (e.g. a block index).
+         * @return Four uniformly distributed 32-bit words.
+         */
+        Block operator()(std::uint64_t counter) const {
+            std::uint32_t c0 = static_cast<std::uint32_t>(counter), c1 = static_cast<std::uint32_t>(counter >> 32);
+            std::uint32_t c2 = static_cast<std::uint32_t>(stream), c3 = static_cast<std::uint32_t>(stream >> 32);
+            std::uint32_t k0 = static_cast<std::uint32_t>(seed), k1 = static_cast<std::uint32_t>(seed >> 32);
+
+            for (int round = 0; round < 10; ++round) {
+                std::uint64_t p0 = static_cast<std::uint64_t>(0xD2511F53u) * c0;
+                std::uint64_t p1 = static_cast<std::uint64_t>(0xCD9E8D57u) * c2;
+                std::uint32_t n0 = static_cast<std::uint32_t>(p1 >> 32) ^ c1 ^ k0;
+                std::uint32_t n2 = static_cast<std::uint32_t>(p0 >> 32) ^ c3 ^ k1;
+                c1 = static_cast<std::uint32_t>(p1);
+                c3 = static_cast<std::uint32_t>(p0);
+                c0 = n0;
+                c2 = n2;
+                k0 += 0x9E3779B9u;
+                k1 += 0xBB67AE85u;
+            }
+            return Block{c0, c1, c2, c3};
+        }
+
+        /**
+         * @brief Unbiased integer in [0, n) derived from one counter value.
+         *
+         * Uses Lemire's multiply-shift with rejection; the rare rejected word moves on to the next
+         * word of the block, then to the next counter in a separate sub-stream.
+         * @param counter The counter.
+         * @param n Exclusive upper bound (> 0).
+         * @return The integer.
+         */
+        std::uint32_t below(std::uint64_t counter, std::uint32_t n) const {
+            std::uint32_t threshold = static_cast<std::uint32_t>(-n) % n;
+            Block block = (*this)(counter);
+            for (std::uint64_t retry = 1;; ++retry) {
+                for (std::uint32_t word : block) {
+                    std::uint64_t product = static_cast<std::uint64_t>(word) * n;
+                    if (static_cast<std::uint32_t>(product) >= threshold) return static_cast<std::uint32_t>(product >> 32);
+                }
+                block = Philox(seed, stream ^ (retry << 63))(counter + retry);
+            }
+        }
+
+        /**
+         * @brief Uniform double in [0, 1) derived from two words.
+         * @param high Upper 32 bits.
+         * @param low Lower 32 bits (only 21 are used).
+         * @return The double.
+         */
+        static double toUnit(std::uint32_t high, std::uint32_t low) {
+            std::uint64_t bits = (static_cast<std::uint64_t>(high) << 21) | (low >> 11);
+            return static_cast<double>(bits) * (1.0 / 9007199254740992.0);
+        }
+
+    private:
+        std::uint64_t seed;   ///< Key
+        std::uint64_t stream; ///< Upper half of the counter
+};
+
+#endif
@@ -0,0 +1,163 @@
+// Inherit from Hamming Decode
+// Decodes only a byte range of an encoded text file
+// Each decoded byte is one fixed 15-byte record, so the range maps straight to a file offset
+// Only the needed records are read with pread(); the rest of the file is never touched
+// Packed containers are located through their trailer chunk index instead
+
+#include <iostream>
+#include <string>
+#include <vector>
+#include <algorithm>
+#include <cstring>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/stat.h>
+#include "Eigen/Dense"
+#include "Hamming.h"
+#include "HammingContainer.h"
+#include "HammingLatency.h"
+
+
+//RangeDecode class constructor
+RangeDecode::RangeDecode(std::string file, std::size_t offset, std::size_t length)
+    : Decode(file, false), rangeOffset(offset), rangeLength(length) {
+    processFile();
+}
+RangeDecode::~RangeDecode() {}
+
+
+void RangeDecode::processFile() {
+    decoded.clear();
+    stats = DecodeStats();
+
+    int fd = open(fileName.c_str(), O_RDONLY);
+    if (fd < 0) {
+        std::cerr << "Error opening file: " << fileName << std::endl;
+        return;
+    }
+
+    char magic[4] = {};
+    if (pread(fd, magic, 4, 0) == 4 && std::memcmp(magic, containerMagic, 4) == 0) {
+        processContainer(fd);
+        close(fd);
+        return;
+    }
+
+    struct stat st;
+    if (fstat(fd, &st) != 0) {
+        std::cerr << "Error reading size of file: " << fileName << std::endl;
+        close(fd);
+        return;
+    }
+
+    //Clamp the range to the records actually present (the last newline may be missing)
+    std::size_t totalRecords = (static_cast<std::size_t>(st.st_size) + 1) / recordSize;
+    if (rangeOffset >= totalRecords || rangeLength == 0) {
+        close(fd);
+        return;
+    }
+    std::size_t count = std::min(rangeLength, totalRecords - rangeOffset);
+
+    //Read all records of the range in a single call
+    std::vector<char> buffer(count * recordSize);
+    off_t start = static_cast<off_t>(rangeOffset * recordSize);
+    std::size_t filled = 0;
+    {
+        LatencyScope latency(LatencyOp::Read);
+        while (filled < buffer.size()) {
+            ssize_t n = pread(fd, buffer.data() + filled, buffer.size() - filled, start + static_cast<off_t>(filled));
+            if (n < 0) {
+                std::cerr << "Error reading file: " << fileName << std::endl;
+                close(fd);
+                return;
+            }
+            if (n == 0) break;
+            filled += static_cast<std::size_t>(n);
+        }
+    }
+    close(fd);
+
+    decoded.reserve(count);
+    for (std::size_t i = 0; i * recordSize + 14 <= filled; ++i) {
+        const char* record = buffer.data() + i * recordSize;
+
+        //A record that is not 14 bits + newline means the file is not in fixed-record form
+        if (i * recordSize + 14 < filled && record[14] != '\n') {
+            std::cerr << "Error: Record " << rangeOffset + i << " is not 14 bits long." << std::endl;
+            return;
+        }
+
+        auto [data1, data2] = parseAndCorrectBlock(std::string(record, 14), stats);
+        decoded += combineDataAndConvertToChar(data1, data2);
+    }
+}
+
+//Only the codewords of the range are read, unless chunks carry a CRC32C; then the covering
+//chunks are read whole so the decoded bytes can be verified before they are returned
+void RangeDecode::processContainer(int fd) {
+    ContainerHeader header;
+    std::vector<ChunkIndexEntry> index;
+    if (!readContainerIndex(fd, header, index)) {
+        std::cerr << "Error: " << fileName << " is not a valid packed container." << std::endl;
+        return;
+    }
+    if (rangeOffset >= header.dataSize || rangeLength == 0) return;
+
+    bool verify = (header.flags & containerFlagCrc) != 0;
+    std::uint64_t end = std::min<std::uint64_t>(header.dataSize, rangeOffset + static_cast<std::uint64_t>(rangeLength));
+    std::vector<unsigned char> encoded;
+    std::vector<char> plain;
+    decoded.reserve(static_cast<std::size_t>(end - rangeOffset));
+
+    for (std::size_t c = rangeOffset / header.chunkSize; c < index.size(); ++c) {
+        std::uint64_t chunkStart = static_cast<std::uint64_t>(c) * header.chunkSize;
+        if (chunkStart >= end) break;
+        const ChunkIndexEntry& entry = index[c];
+
+        std::uint64_t first = verify ? 0 : std::max<std::uint64_t>(rangeOffset, chunkStart) - chunkStart;
+        std::uint64_t last = verify ? entry.length : std::min<std::uint64_t>(end - chunkStart, entry.length);
+        encoded.resize(static_cast<std::size_t>(last - first) * containerBytesPerByte);
+        plain.resize(static_cast<std::size_t>(last - first));
+
+        off_t at = static_cast<off_t>(entry.offset + first * containerBytesPerByte);
+        ssize_t got;
+        {
+            LatencyScope latency(LatencyOp::Read);
+            got = pread(fd, encoded.data(), encoded.size(), at);
+        }
+        if (got != static_cast<ssize_t>(encoded.size())) {
+            std::cerr << "Error: Chunk " << c << " is truncated." << std::endl;
+            decoded.clear();
+            return;
+        }
+
+        for (std::size_t i = 0; i < plain.size(); ++i) {
+            unsigned char high = encoded[2 * i] & 0x7F, low = encoded[2 * i + 1] & 0x7F;
+            stats.record(syndromeTable[high]);
+            stats.record(syndromeTable[low]);
+            plain[i] = static_cast<char>((correctTable[high] << 4) | correctTable[low]);
+        }
+
+        if (verify && crc32c(plain.data(), plain.size()) != entry.crc) {
+            stats.uncorrectable += plain.size() * containerBytesPerByte;
+            std::cerr << "Error: Chunk " << c << " failed its CRC32C check (uncorrectable errors)." << std::endl;
+            decoded.clear();
+            return;
+        }
+
+        std::uint64_t from = std::max<std::uint64_t>(rangeOffset, chunkStart) - chunkStart - first;
+        std::uint64_t to = std::min<std::uint64_t>(end - chunkStart, entry.length) - first;
+        decoded.append(plain.data() + from, static_cast<std::size_t>(to - from));
+    }
+}
+
+//Getter method
+const std::string& RangeDecode::getDecoded() const {
+    return decoded;
+}
+
+//Convenience wrapper around RangeDecode
+std::string decodeRange(const std::string& path, std::size_t offset, std::size_t length) {
+    RangeDecode rangeDecode(path, offset, length);
+    return rangeDecode.getDecoded();
+}
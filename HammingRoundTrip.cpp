@@ -0,0 +1,106 @@
+// Fused round trip: encode, channel, decode and compare in one pass
+// Each chunk is table-encoded into packed codewords, corrupted by the channel model, corrected
+// and compared with the input while it is still in cache; nothing touches the disk but the read
+
+#include <iostream>
+#include <iomanip>
+#include <fstream>
+#include <string>
+#include <vector>
+#include <chrono>
+#include <memory>
+#include "Hamming.h"
+#include "HammingChannel.h"
+#include "HammingLatency.h"
+#include "HammingMetrics.h"
+#include "HammingProfile.h"
+#include "HammingTrace.h"
+
+
+//RoundTrip class constructor
+RoundTrip::RoundTrip(std::string file, std::string channel, std::uint64_t seed, std::size_t chunkSize)
+    : Hamming(file), channel(channel), seed(seed), chunkSize(chunkSize ? chunkSize : defaultChunkSize) {
+    processFile();
+}
+RoundTrip::~RoundTrip() {}
+
+
+const RoundTrip::Summary& RoundTrip::getSummary() const {
+    return summary;
+}
+
+void RoundTrip::processFile() {
+    std::unique_ptr<Channel> model = Channel::create(channel, seed);
+    if (!model) {
+        summary.failed = true;
+        return;
+    }
+    std::ifstream inputFile(fileName, std::ios::in | std::ios::binary);
+    if (!inputFile.is_open()) {
+        std::cerr << "Error opening file: " << fileName << std::endl;
+        summary.failed = true;
+        return;
+    }
+
+    std::vector<char> in(chunkSize);
+    std::vector<unsigned char> codewords(chunkSize * 2);
+    auto start = std::chrono::steady_clock::now();
+
+    for (std::size_t chunk = 0;; ++chunk) {
+        std::size_t length;
+        {
+            HAMMING_PROFILE_SCOPE(Read);
+            TraceScope trace("read", chunk);
+            LatencyScope latency(LatencyOp::Read);
+            inputFile.read(in.data(), static_cast<std::streamsize>(in.size()));
+            length = static_cast<std::size_t>(inputFile.gcount());
+        }
+        if (inputFile.bad()) {
+            std::cerr << "Error reading file: " << fileName << std::endl;
+            summary.failed = true;
+            return;
+        }
+        if (length == 0) break;
+        {
+            HAMMING_PROFILE_SCOPE(Kernel);
+            TraceScope trace("encode", chunk);
+            LatencyScope latency(LatencyOp::Encode);
+            for (std::size_t i = 0; i < length; ++i) {
+                unsigned char ch = static_cast<unsigned char>(in[i]);
+                codewords[2 * i] = encodeTable[ch >> 4];
+                codewords[2 * i + 1] = encodeTable[ch & 0x0F];
+            }
+        }
+        {
+            HAMMING_PROFILE_SCOPE(Inject);
+            TraceScope trace("inject", chunk);
+            summary.flipped += model->apply(codewords.data(), length * 2);
+        }
+
+        //Correct, decode and compare; diff holds the wrong bits of each byte
+        HAMMING_PROFILE_SCOPE(Kernel);
+        TraceScope trace("decode", chunk);
+        LatencyScope latency(LatencyOp::Decode);
+        std::size_t correctedBefore = summary.corrected;
+        for (std::size_t i = 0; i < length; ++i) {
+            unsigned char high = codewords[2 * i], low = codewords[2 * i + 1];
+            summary.corrected += (syndromeTable[high] != 0) + (syndromeTable[low] != 0);
+            unsigned diff = static_cast<unsigned>((correctTable[high] << 4) | correctTable[low]) ^ static_cast<unsigned char>(in[i]);
+            if (diff) {
+                ++summary.byteErrors;
+                summary.bitErrors += static_cast<std::size_t>(__builtin_popcount(diff));
+                summary.blockErrors += ((diff >> 4) != 0) + ((diff & 0x0F) != 0);
+            }
+        }
+        summary.bytes += length;
+        summary.blocks += length * 2;
+        Metrics::count(length, length, length * 2, summary.corrected - correctedBefore);
+    }
+    summary.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    std::cout << "Round trip of " << fileName << " through " << channel << ": " << summary.bytes << " bytes, " << summary.blocks
+              << " blocks, " << summary.flipped << " bits flipped, " << summary.corrected << " corrected. Residual errors: "
+              << summary.byteErrors << " bytes, " << summary.bitErrors << " bits, " << summary.blockErrors << " blocks. "
+              << std::fixed << std::setprecision(1) << (summary.seconds > 0 ? summary.bytes / summary.seconds / 1e6 : 0.0) << " MB/s.\n"
+              << std::defaultfloat;
+}
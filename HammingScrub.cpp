@@ -0,0 +1,221 @@
+// Scrubs stored encoded files in place
+// The file is mapped read-only and every codeword's syndrome is computed from the lookup tables
+// Only records that held a correctable error are rewritten (pwrite), so a mostly clean file costs a read
+// Packed container chunks are re-verified against their CRC32C before any fix is written back
+
+#include <iostream>
+#include <string>
+#include <vector>
+#include <cstring>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include "Hamming.h"
+#include "HammingContainer.h"
+#include "HammingLatency.h"
+#include "HammingMetrics.h"
+
+
+//Scrub class constructor
+Scrub::Scrub(std::string file) : Hamming(file) {
+    processFile();
+}
+Scrub::~Scrub() {}
+
+
+void Scrub::processFile() {
+    summary = Summary();
+
+    int fd = open(fileName.c_str(), O_RDWR);
+    if (fd < 0) {
+        std::cerr << "Error opening file: " << fileName << std::endl;
+        return;
+    }
+
+    struct stat st;
+    if (fstat(fd, &st) != 0 || st.st_size == 0) {
+        std::cerr << "Error: " << fileName << " is empty or unreadable." << std::endl;
+        close(fd);
+        return;
+    }
+    std::size_t size = static_cast<std::size_t>(st.st_size);
+
+    void* mapping = mmap(nullptr, size, PROT_READ, MAP_SHARED, fd, 0);
+    if (mapping == MAP_FAILED) {
+        std::cerr << "Error mapping file: " << fileName << std::endl;
+        close(fd);
+        return;
+    }
+    madvise(mapping, size, MADV_SEQUENTIAL);
+
+    const char* data = static_cast<const char*>(mapping);
+    if (size >= 4 && std::memcmp(data, containerMagic, 4) == 0) {
+        scrubContainer(fd, static_cast<const unsigned char*>(mapping));
+    } else {
+        scrubText(fd, data, size);
+    }
+
+    munmap(mapping, size);
+    close(fd);
+
+    std::cout << "Scrub complete for " << fileName << ": " << summary.records << " records scanned, "
+              << summary.correctedBlocks << " blocks corrected, " << summary.rewrittenBytes << " bytes rewritten in "
+              << summary.writes << " writes, " << summary.malformed << " malformed lines, "
+              << summary.failedChunks << " chunks failed CRC.\n";
+}
+
+
+//Text format: 14 binary digits per line, two 7-bit codewords
+void Scrub::scrubText(int fd, const char* data, std::size_t size) {
+    std::vector<char> run;      //Corrected bytes of the current run of adjacent dirty records
+    std::size_t runStart = 0;
+    run.reserve(maxRunBytes);   //Runs are flushed when full, so the buffer never regrows
+
+    std::size_t pos = 0;
+    while (pos < size) {
+        const char* newline = static_cast<const char*>(std::memchr(data + pos, '\n', size - pos));
+        std::size_t lineEnd = newline ? static_cast<std::size_t>(newline - data) : size;
+        std::size_t next = newline ? lineEnd + 1 : size;
+        const char* line = data + pos;
+
+        bool dirty = false;
+        bool valid = (lineEnd - pos == 14);
+        unsigned char words[2] = {0, 0};
+        for (std::size_t i = 0; valid && i < 14; ++i) {
+            if (line[i] != '0' && line[i] != '1') valid = false;
+            words[i / 7] = static_cast<unsigned char>((words[i / 7] << 1) | (line[i] - '0'));
+        }
+
+        std::size_t corrected = 0;
+        if (!valid) {
+            if (lineEnd != pos) ++summary.malformed;
+        } else {
+            ++summary.records;
+            for (unsigned char word : words) {
+                if (syndromeTable[word] != 0) {
+                    ++corrected;
+                    dirty = true;
+                }
+            }
+            summary.correctedBlocks += corrected;
+        }
+        Metrics::count(next - pos, 0, valid ? 2 : 0, corrected);
+
+        //Flush the pending run once a record doesn't extend it
+        if (!run.empty() && (!dirty || runStart + run.size() != pos || run.size() + 15 > maxRunBytes)) {
+            if (!writeBack(fd, run.data(), run.size(), runStart)) return;
+            run.clear();
+        }
+
+        if (dirty) {
+            if (run.empty()) runStart = pos;
+            for (int half = 0; half < 2; ++half) {
+                unsigned char fixed = encodeTable[correctTable[words[half]]];
+                for (int j = 0; j < 7; ++j) run.push_back(static_cast<char>('0' + ((fixed >> (6 - j)) & 1)));
+            }
+            if (newline) run.push_back('\n');
+        }
+
+        pos = next;
+    }
+
+    if (!run.empty()) writeBack(fd, run.data(), run.size(), runStart);
+}
+
+
+//Packed container: each byte is one codeword; a chunk's fixes are only written if its CRC32C still holds
+void Scrub::scrubContainer(int fd, const unsigned char* data) {
+    ContainerHeader header;
+    std::vector<ChunkIndexEntry> index;
+    if (!readContainerIndex(fd, header, index)) {
+        std::cerr << "Error: " << fileName << " is not a valid packed container." << std::endl;
+        return;
+    }
+    bool verify = (header.flags & containerFlagCrc) != 0;
+
+    std::vector<unsigned char> fixed;
+    std::vector<char> plain;
+
+    for (std::size_t c = 0; c < index.size(); ++c) {
+        const ChunkIndexEntry& entry = index[c];
+        const unsigned char* body = data + entry.offset;
+        std::size_t words = static_cast<std::size_t>(entry.length) * containerBytesPerByte;
+        summary.records += entry.length;
+
+        //Fast path: a clean chunk is only read
+        std::size_t firstDirty = words;
+        for (std::size_t i = 0; i < words; ++i) {
+            if (body[i] > 0x7F || syndromeTable[body[i]] != 0) {
+                firstDirty = i;
+                break;
+            }
+        }
+        if (firstDirty == words) {
+            Metrics::count(words, 0, words);
+            continue;
+        }
+
+        fixed.assign(body, body + words);
+        std::size_t corrected = 0;
+        for (std::size_t i = firstDirty; i < words; ++i) {
+            if (fixed[i] > 0x7F || syndromeTable[fixed[i]] != 0) {
+                fixed[i] = encodeTable[correctTable[fixed[i] & 0x7F]];
+                ++corrected;
+            }
+        }
+
+        if (verify) {
+            plain.resize(entry.length);
+            for (std::size_t i = 0; i < entry.length; ++i) {
+                plain[i] = static_cast<char>((correctTable[fixed[2 * i]] << 4) | correctTable[fixed[2 * i + 1]]);
+            }
+            if (crc32c(plain.data(), plain.size()) != entry.crc) {
+                std::cerr << "Error: Chunk " << c << " failed its CRC32C check; left unchanged." << std::endl;
+                ++summary.failedChunks;
+                Metrics::count(words, 0, words, 0, words);
+                continue;
+            }
+        }
+        summary.correctedBlocks += corrected;
+        Metrics::count(words, 0, words, corrected);
+
+        //Write back each run of changed bytes
+        std::size_t i = firstDirty;
+        while (i < words) {
+            if (fixed[i] == body[i]) {
+                ++i;
+                continue;
+            }
+            std::size_t runEnd = i + 1;
+            while (runEnd < words && fixed[runEnd] != body[runEnd]) ++runEnd;
+            if (!writeBack(fd, fixed.data() + i, runEnd - i, static_cast<std::size_t>(entry.offset) + i)) return;
+            i = runEnd;
+        }
+    }
+}
+
+
+//Helper function
+bool Scrub::writeBack(int fd, const void* bytes, std::size_t length, std::size_t offset) {
+    LatencyScope latency(LatencyOp::Write);
+    const char* p = static_cast<const char*>(bytes);
+    std::size_t done = 0;
+    while (done < length) {
+        ssize_t n = pwrite(fd, p + done, length - done, static_cast<off_t>(offset + done));
+        if (n <= 0) {
+            std::cerr << "Error writing file: " << fileName << std::endl;
+            return false;
+        }
+        done += static_cast<std::size_t>(n);
+    }
+    summary.rewrittenBytes += length;
+    Metrics::count(0, length, 0);
+    ++summary.writes;
+    return true;
+}
+
+//Getter method
+const Scrub::Summary& Scrub::getSummary() const {
+    return summary;
+}
@@ -0,0 +1,300 @@
+// Shared-memory ring transport for co-located producers
+// A named shm_open() region holds a control block and paired input/output slot rings
+// Producers claim free slots and write plaintext into them; the codec process encodes each slot
+// straight into its paired output slot, and the producer reads its codewords from there: no copies
+// between processes. The codec serves producers one after another or at once until it is signaled
+// Waiting spins briefly and then sleeps with FUTEX_WAIT on the shared counter
+
+#include <iostream>
+#include <fstream>
+#include <string>
+#include <vector>
+#include <climits>
+#include <csignal>
+#include <new>
+#include <fcntl.h>
+#include <unistd.h>
+#include <linux/futex.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <sys/syscall.h>
+#include "HammingShm.h"
+
+namespace {
+    volatile std::sig_atomic_t stopRequested = 0;
+
+    void requestStop(int) {
+        stopRequested = 1;
+    }
+
+    long futex(std::atomic<std::uint32_t>& word, int op, std::uint32_t value) {
+        return syscall(SYS_futex, reinterpret_cast<std::uint32_t*>(&word), op, value, nullptr, nullptr, 0);
+    }
+
+    std::size_t alignUp(std::size_t value) {
+        return (value + 63) & ~static_cast<std::size_t>(63);
+    }
+}
+
+
+//Creating constructor
+ShmRing::ShmRing(const std::string& name, std::uint32_t slotCount, std::uint32_t slotSize) : name(name), owner(true) {
+    shm_unlink(name.c_str());
+    int fd = shm_open(name.c_str(), O_RDWR | O_CREAT | O_EXCL, 0600);
+    std::size_t bytes = regionSize(slotCount, slotSize);
+    if (fd < 0 || ftruncate(fd, static_cast<off_t>(bytes)) != 0 || !map(fd, bytes)) {
+        std::cerr << "Error creating shared memory region: " << name << std::endl;
+        if (fd >= 0) close(fd);
+        shm_unlink(name.c_str());
+        owner = false;
+        return;
+    }
+    close(fd);
+
+    ShmHeader* control = new (base) ShmHeader();
+    control->slotCount = slotCount;
+    control->slotSize = slotSize;
+    map(-1, bytes);
+    __atomic_store_n(&control->magic, shmMagic, __ATOMIC_RELEASE);
+}
+
+//Attaching constructor
+ShmRing::ShmRing(const std::string& name) : name(name) {
+    int fd = shm_open(name.c_str(), O_RDWR, 0);
+    struct stat st;
+    if (fd < 0 || fstat(fd, &st) != 0 || static_cast<std::size_t>(st.st_size) < sizeof(ShmHeader)
+        || !map(fd, static_cast<std::size_t>(st.st_size))) {
+        std::cerr << "Error attaching shared memory region: " << name << std::endl;
+        if (fd >= 0) close(fd);
+        return;
+    }
+    close(fd);
+
+    ShmHeader& control = header();
+    if (__atomic_load_n(&control.magic, __ATOMIC_ACQUIRE) != shmMagic
+        || regionSize(control.slotCount, control.slotSize) != size) {
+        std::cerr << "Error: " << name << " is not a Hamming ring." << std::endl;
+        munmap(base, size);
+        base = nullptr;
+        return;
+    }
+    map(-1, size);
+}
+
+ShmRing::~ShmRing() {
+    if (base) munmap(base, size);
+    if (owner) shm_unlink(name.c_str());
+}
+
+
+bool ShmRing::isOpen() const {
+    return base != nullptr;
+}
+
+ShmHeader& ShmRing::header() const {
+    return *static_cast<ShmHeader*>(base);
+}
+
+std::atomic<std::uint32_t>& ShmRing::state(std::uint32_t slot) const {
+    return states[slot];
+}
+
+char* ShmRing::input(std::uint32_t slot) const {
+    return inputs + static_cast<std::size_t>(slot) * header().slotSize;
+}
+
+unsigned char* ShmRing::output(std::uint32_t slot) const {
+    return outputs + static_cast<std::size_t>(slot) * header().slotSize * 2;
+}
+
+std::uint32_t& ShmRing::length(std::uint32_t slot) const {
+    return lengths[slot];
+}
+
+std::uint32_t ShmRing::claim() const {
+    std::uint32_t slots = header().slotCount;
+    for (std::uint32_t slot = 0; slot < slots; ++slot) {
+        std::uint32_t expected = shmFree;
+        if (states[slot].load(std::memory_order_relaxed) == shmFree
+            && states[slot].compare_exchange_strong(expected, shmClaimed, std::memory_order_acquire)) {
+            return slot;
+        }
+    }
+    return slots;
+}
+
+void ShmRing::waitWhile(std::atomic<std::uint32_t>& word, std::uint32_t value) const {
+    for (int spins = 0; spins < 1000; ++spins) {
+        if (word.load(std::memory_order_acquire) != value) return;
+#if defined(__x86_64__) || defined(__i386__)
+        __builtin_ia32_pause();
+#endif
+    }
+
+    //Announce the sleep before the final check, so a waker either sees us or we see its update
+    std::atomic<std::uint32_t>& sleepers = header().sleepers;
+    sleepers.fetch_add(1, std::memory_order_seq_cst);
+    if (word.load(std::memory_order_seq_cst) == value && !header().closed.load(std::memory_order_seq_cst)) {
+        futex(word, FUTEX_WAIT, value);
+    }
+    sleepers.fetch_sub(1, std::memory_order_seq_cst);
+}
+
+//Callers publish the counter with a release increment, which a later load may pass; the fence keeps the
+//sleepers check after it, or a waiter could announce itself, still see the old value and sleep for good
+void ShmRing::wake(std::atomic<std::uint32_t>& word) const {
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    if (header().sleepers.load(std::memory_order_seq_cst) != 0) futex(word, FUTEX_WAKE, INT_MAX);
+}
+
+
+//With fd >= 0 maps the region; with fd < 0 only locates the arrays inside an existing mapping
+bool ShmRing::map(int fd, std::size_t bytes) {
+    if (fd >= 0) {
+        void* mapping = mmap(nullptr, bytes, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+        if (mapping == MAP_FAILED) return false;
+        base = mapping;
+        size = bytes;
+        return true;
+    }
+
+    char* p = static_cast<char*>(base) + alignUp(sizeof(ShmHeader));
+    std::uint32_t slots = header().slotCount;
+    states = reinterpret_cast<std::atomic<std::uint32_t>*>(p);
+    p += alignUp(sizeof(std::atomic<std::uint32_t>) * slots);
+    lengths = reinterpret_cast<std::uint32_t*>(p);
+    p += alignUp(sizeof(std::uint32_t) * slots);
+    inputs = p;
+    p += alignUp(static_cast<std::size_t>(slots) * header().slotSize);
+    outputs = reinterpret_cast<unsigned char*>(p);
+    return true;
+}
+
+std::size_t ShmRing::regionSize(std::uint32_t slotCount, std::uint32_t slotSize) {
+    return alignUp(sizeof(ShmHeader)) + alignUp(sizeof(std::atomic<std::uint32_t>) * slotCount) + alignUp(sizeof(std::uint32_t) * slotCount)
+           + alignUp(static_cast<std::size_t>(slotCount) * slotSize) + static_cast<std::size_t>(slotCount) * slotSize * 2;
+}
+
+
+//ShmCodec class constructor
+ShmCodec::ShmCodec(std::string name, std::uint32_t slotCount, std::uint32_t slotSize)
+    : Hamming(name), slotCount(slotCount ? slotCount : defaultSlotCount), slotSize(slotSize ? slotSize : defaultSlotSize) {
+    processFile();
+}
+ShmCodec::~ShmCodec() {}
+
+
+void ShmCodec::processFile() {
+    ShmRing ring(fileName, slotCount, slotSize);
+    if (!ring.isOpen()) return;
+    ShmHeader& control = ring.header();
+
+    //No SA_RESTART, so a signal also ends the FUTEX_WAIT of an idle ring
+    struct sigaction action = {};
+    action.sa_handler = requestStop;
+    sigaction(SIGINT, &action, nullptr);
+    sigaction(SIGTERM, &action, nullptr);
+    std::cout << "Serving shared memory ring " << fileName << " (" << slotCount << " slots of " << slotSize << " bytes).\n" << std::flush;
+
+    //Each pass encodes every ready slot, starting after the last one so no producer is starved
+    std::size_t bytes = 0;
+    std::uint32_t start = 0;
+    while (!stopRequested) {
+        std::uint32_t seen = control.ready.load(std::memory_order_acquire);
+        bool any = false;
+        for (std::uint32_t k = 0; k < slotCount; ++k) {
+            std::uint32_t slot = (start + k) % slotCount;
+            if (ring.state(slot).load(std::memory_order_acquire) != shmReady) continue;
+
+            const unsigned char* in = reinterpret_cast<const unsigned char*>(ring.input(slot));
+            unsigned char* out = ring.output(slot);
+            std::uint32_t length = ring.length(slot);
+            for (std::uint32_t i = 0; i < length; ++i) {
+                out[2 * i] = encodeTable[in[i] >> 4];
+                out[2 * i + 1] = encodeTable[in[i] & 0x0F];
+            }
+            bytes += length;
+            ring.state(slot).store(shmEncoded, std::memory_order_release);
+            control.encoded.fetch_add(1, std::memory_order_release);
+            ring.wake(control.encoded);
+            start = slot + 1;
+            any = true;
+        }
+        if (!any) ring.waitWhile(control.ready, seen);
+    }
+
+    //Producers still attached see closed and give up instead of waiting for a codec that is gone
+    control.closed.store(1, std::memory_order_seq_cst);
+    ring.wake(control.ready);
+    ring.wake(control.encoded);
+    ring.wake(control.freed);
+    std::cout << "Shared memory ring stopped after " << bytes << " bytes.\n";
+}
+
+
+//Producer and consumer of its own slots in one loop: keep claiming free slots while there is input,
+//and hand codewords out in claim order, which is input order
+bool shmEncodeFile(const std::string& name, const std::string& inFile, const std::string& outFile) {
+    ShmRing ring(name);
+    if (!ring.isOpen()) return false;
+    ShmHeader& control = ring.header();
+
+    std::ifstream input(inFile, std::ios::in | std::ios::binary);
+    std::ofstream output(outFile, std::ios::out | std::ios::binary | std::ios::trunc);
+    if (!input.is_open() || !output.is_open()) {
+        std::cerr << "Error opening file: " << (input.is_open() ? outFile : inFile) << std::endl;
+        return false;
+    }
+
+    std::vector<std::uint32_t> mine;   //Claimed slots, oldest first
+    mine.reserve(control.slotCount);
+    bool eof = false;
+
+    while (!eof || !mine.empty()) {
+        if (control.closed.load(std::memory_order_acquire)) {
+            std::cerr << "Error: shared memory ring " << name << " was closed by its server." << std::endl;
+            return false;
+        }
+
+        //Fill free input slots directly from the file. The counter is read before the scan, so a
+        //slot freed after it moves the counter and the wait below does not sleep through it
+        std::uint32_t freed = control.freed.load(std::memory_order_acquire);
+        while (!eof) {
+            std::uint32_t slot = ring.claim();
+            if (slot == control.slotCount) break;
+            input.read(ring.input(slot), control.slotSize);
+            std::uint32_t length = static_cast<std::uint32_t>(input.gcount());
+            if (length == 0) {
+                eof = true;
+                ring.state(slot).store(shmFree, std::memory_order_release);
+                control.freed.fetch_add(1, std::memory_order_release);
+                ring.wake(control.freed);
+                break;
+            }
+            ring.length(slot) = length;
+            ring.state(slot).store(shmReady, std::memory_order_release);
+            control.ready.fetch_add(1, std::memory_order_release);
+            ring.wake(control.ready);
+            mine.push_back(slot);
+        }
+        if (mine.empty()) {
+            if (!eof) ring.waitWhile(control.freed, freed);
+            continue;
+        }
+
+        //Read the oldest slot's codewords straight out of the ring and free it
+        std::uint32_t encoded = control.encoded.load(std::memory_order_acquire);
+        std::uint32_t slot = mine.front();
+        if (ring.state(slot).load(std::memory_order_acquire) != shmEncoded) {
+            ring.waitWhile(control.encoded, encoded);
+            continue;
+        }
+        output.write(reinterpret_cast<const char*>(ring.output(slot)), static_cast<std::streamsize>(ring.length(slot)) * 2);
+        ring.state(slot).store(shmFree, std::memory_order_release);
+        control.freed.fetch_add(1, std::memory_order_release);
+        ring.wake(control.freed);
+        mine.erase(mine.begin());
+    }
+
+    return static_cast<bool>(output);
+}
@@ -0,0 +1,208 @@
+/* Colton Criswell and Zach Hamby
+ * Final Project - CS-300
+ */
+
+#ifndef HAMMING_SHM_H
+#define HAMMING_SHM_H
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include "Hamming.h"
+
+/**
+ * @struct ShmHeader
+ * @brief Control block at the start of a shared-memory ring region.
+ *
+ * Slot i of the input ring is paired with slot i of the output ring, and each pair has a state
+ * word: any number of producers claim a free slot with a compare-and-swap, fill it and mark it
+ * ready; the codec encodes ready slots and marks them encoded; the producer that claimed a slot
+ * reads its codewords and frees it. The counters only grow (modulo 2^32) and exist to be slept
+ * on: sleepers wait on one with FUTEX_WAIT and are woken when it moves.
+ */
+struct ShmHeader {
+    std::uint32_t magic;     ///< shmMagic once the region is initialized
+    std::uint32_t slotCount; ///< Number of slot pairs
+    std::uint32_t slotSize;  ///< Plaintext bytes per input slot
+    std::uint32_t reserved;  ///< Zero
+
+    alignas(64) std::atomic<std::uint32_t> ready;    ///< Bumped whenever a producer marks a slot ready
+    alignas(64) std::atomic<std::uint32_t> encoded;  ///< Bumped whenever the codec marks a slot encoded
+    alignas(64) std::atomic<std::uint32_t> freed;    ///< Bumped whenever a producer frees a slot
+    alignas(64) std::atomic<std::uint32_t> closed;   ///< Set by the codec when it stops serving
+    std::atomic<std::uint32_t> sleepers;             ///< Threads blocked in FUTEX_WAIT
+};
+
+static const std::uint32_t shmMagic = 0x52534D48; ///< "HMSR"
+static const std::uint32_t shmFree = 0;           ///< Slot state: unclaimed
+static const std::uint32_t shmClaimed = 1;        ///< Slot state: a producer is filling it
+static const std::uint32_t shmReady = 2;          ///< Slot state: waiting for the codec
+static const std::uint32_t shmEncoded = 3;        ///< Slot state: codewords waiting for their producer
+
+/**
+ * @class ShmRing
+ * @brief Shared-memory region holding paired input/output slot rings.
+ *
+ * Producers write plaintext straight into input slots and the codec process writes codewords
+ * straight into the paired output slots (one 7-bit codeword per byte, two per plaintext byte,
+ * like the packed container), so no data is copied between processes. A producer that dies
+ * holding slots leaves them claimed until the region is recreated.
+ */
+class ShmRing {
+
+    public:
+        /**
+         * @brief Creates a new region (replacing any stale one of the same name).
+         * @param name shm_open() name, e.g. "/hamming".
+         * @param slotCount Number of slot pairs.
+         * @param slotSize Plaintext bytes per input slot.
+         */
+        ShmRing(const std::string& name, std::uint32_t slotCount, std::uint32_t slotSize);
+
+        /**
+         * @brief Attaches to an existing region.
+         * @param name shm_open() name used by the creator.
+         */
+        explicit ShmRing(const std::string& name);
+
+        /**
+         * @brief Destructor for ShmRing class; unmaps, and unlinks the name if this side created it.
+         */
+        ~ShmRing();
+
+        ShmRing(const ShmRing&) = delete;
+        ShmRing& operator=(const ShmRing&) = delete;
+
+        /**
+         * @brief Checks whether the region was created or attached.
+         * @return True if usable.
+         */
+        bool isOpen() const;
+
+        /**
+         * @brief Getter for the control block.
+         * @return The shared header.
+         */
+        ShmHeader& header() const;
+
+        /**
+         * @brief State word of a slot pair (shmFree, shmClaimed, shmReady or shmEncoded).
+         * @param slot Slot index, below slotCount.
+         * @return Reference to the shared state.
+         */
+        std::atomic<std::uint32_t>& state(std::uint32_t slot) const;
+
+        /**
+         * @brief Input slot storage.
+         * @param slot Slot index, below slotCount.
+         * @return Pointer to slotSize bytes.
+         */
+        char* input(std::uint32_t slot) const;
+
+        /**
+         * @brief Output slot storage.
+         * @param slot Slot index, below slotCount.
+         * @return Pointer to 2 * slotSize bytes.
+         */
+        unsigned char* output(std::uint32_t slot) const;
+
+        /**
+         * @brief Valid plaintext bytes of an input slot (the output holds twice as many).
+         * @param slot Slot index, below slotCount.
+         * @return Reference to the shared length.
+         */
+        std::uint32_t& length(std::uint32_t slot) const;
+
+        /**
+         * @brief Claims a free slot for the caller.
+         * @return The slot index, or slotCount if every slot is taken.
+         */
+        std::uint32_t claim() const;
+
+        /**
+         * @brief Blocks while a counter still holds a value (spins briefly, then FUTEX_WAIT).
+         * @param word The counter.
+         * @param value The value to wait past.
+         */
+        void waitWhile(std::atomic<std::uint32_t>& word, std::uint32_t value) const;
+
+        /**
+         * @brief Wakes everyone blocked on a counter, if anyone is.
+         * @param word The counter.
+         */
+        void wake(std::atomic<std::uint32_t>& word) const;
+
+    private:
+        /**
+         * @brief Maps the region and locates the slot arrays.
+         * @param fd Descriptor from shm_open().
+         * @param size Region size in bytes.
+         * @return False if mmap() failed.
+         */
+        bool map(int fd, std::size_t size);
+
+        /**
+         * @brief Size of a region.
+         * @param slotCount Number of slot pairs.
+         * @param slotSize Plaintext bytes per input slot.
+         * @return Bytes needed.
+         */
+        static std::size_t regionSize(std::uint32_t slotCount, std::uint32_t slotSize);
+
+        std::string name;            ///< shm_open() name
+        bool owner = false;          ///< Whether this side created (and will unlink) the region
+        void* base = nullptr;        ///< Mapping
+        std::size_t size = 0;        ///< Mapping size
+        std::atomic<std::uint32_t>* states = nullptr; ///< Per-slot states
+        std::uint32_t* lengths = nullptr;   ///< Per-slot plaintext lengths
+        char* inputs = nullptr;             ///< Input slot storage
+        unsigned char* outputs = nullptr;   ///< Output slot storage
+};
+
+/**
+ * @class ShmCodec
+ * @brief Derived class serving a shared-memory ring: encodes every input slot into its output slot.
+ */
+class ShmCodec : public Hamming {
+
+    public:
+        static const std::uint32_t defaultSlotCount = 16;        ///< Slot pairs in a new region
+        static const std::uint32_t defaultSlotSize = 1 << 20;    ///< Plaintext bytes per slot
+
+        /**
+         * @brief Constructor for ShmCodec class; creates the region and serves producers until SIGINT or SIGTERM.
+         * @param name shm_open() name of the region.
+         * @param slotCount Number of slot pairs.
+         * @param slotSize Plaintext bytes per input slot.
+         */
+        ShmCodec(std::string name, std::uint32_t slotCount = defaultSlotCount, std::uint32_t slotSize = defaultSlotSize);
+
+        /**
+         * @brief Destructor for ShmCodec class.
+         */
+        ~ShmCodec();
+
+    private:
+        /**
+         * @brief Encodes ready input slots until a stop signal, then closes the ring.
+         */
+        void processFile() override;
+
+        std::uint32_t slotCount; ///< Number of slot pairs
+        std::uint32_t slotSize;  ///< Plaintext bytes per input slot
+};
+
+/**
+ * @brief Streams a file through a served ring, acting as both producer and consumer of its own slots.
+ *
+ * Any number of these may share one ring at the same time; each claims free slots as its input
+ * allows and writes its codewords in its own input order.
+ * @param name shm_open() name of the region.
+ * @param inFile Plain input file.
+ * @param outFile Receives the codewords (two bytes per input byte).
+ * @return False if the ring could not be attached, was closed by its server, or a file failed.
+ */
+bool shmEncodeFile(const std::string& name, const std::string& inFile, const std::string& outFile);
+
+#endif
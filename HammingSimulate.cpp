@@ -0,0 +1,176 @@
+// Monte Carlo BER/BLER simulation
+// Codewords are bit-sliced: column j of 64 codewords is one 64-bit word, so encoding, syndrome
+// and correction run on 64 blocks per logic operation
+// Channels come from HammingChannel.h; groups the channel leaves untouched decode to themselves
+// and are counted without being generated, so low error rates cost time per error
+// Every thread owns its message and channel streams and merges counters once per batch
+
+#include <iostream>
+#include <iomanip>
+#include <string>
+#include <vector>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include "HammingSimulate.h"
+#include "HammingChannel.h"
+#include "ThreadPool.h"
+
+namespace {
+    const std::size_t batchGroups = 1 << 14;  //64-codeword groups per thread between merges
+}
+
+
+//Simulate class constructor
+Simulate::Simulate(std::vector<std::string> channels, std::uint64_t maxBlocks, double precision, unsigned threads, std::uint64_t seed,
+                   double floor, double maxSeconds)
+    : Hamming("<simulate>"), channels(channels), maxBlocks(maxBlocks), precision(precision),
+      threads(ThreadPool::resolveThreads(threads)), seed(seed), floor(floor), maxSeconds(maxSeconds) {
+    processFile();
+}
+Simulate::~Simulate() {}
+
+
+const std::vector<Simulate::Point>& Simulate::getResults() const {
+    return results;
+}
+
+void Simulate::processFile() {
+    //The bit-sliced decoder must agree with the decoder's table on all 128 received words
+    for (int half = 0; half < 2; ++half) {
+        std::uint64_t word[7] = {};
+        for (int lane = 0; lane < 64; ++lane) {
+            for (int j = 0; j < 7; ++j) word[j] |= static_cast<std::uint64_t>(((half * 64 + lane) >> (6 - j)) & 1) << lane;
+        }
+        correctSliced(word);
+        for (int lane = 0; lane < 64; ++lane) {
+            int message = 0;
+            for (int i = 0; i < 4; ++i) message |= static_cast<int>((word[sliceDataColumn[i]] >> lane) & 1) << (3 - i);
+            if (message != correctTable[half * 64 + lane]) {
+                std::cerr << "Error: bit-sliced decoder disagrees with the correction table." << std::endl;
+                return;
+            }
+        }
+    }
+
+    std::cout << "code   channel                      blocks   channel BER  residual BER [95% interval]           residual BLER [95% interval]          Mblocks/s  stop\n" << std::flush;
+    for (const std::string& spec : channels) {
+        Point point;
+        if (!run(spec, point)) continue;
+        results.push_back(point);
+
+        std::cout << std::left << std::setw(7) << "(7,4)" << std::setw(22) << spec << std::right << std::setw(15) << point.blocks
+                  << std::scientific << std::setprecision(3)
+                  << std::setw(14) << static_cast<double>(point.flips) / (7.0 * static_cast<double>(point.blocks))
+                  << std::setw(12) << point.ber[0] << " [" << point.ber[1] << ", " << point.ber[2] << "]"
+                  << std::setw(12) << point.bler[0] << " [" << point.bler[1] << ", " << point.bler[2] << "]"
+                  << std::fixed << std::setprecision(1) << std::setw(11) << static_cast<double>(point.blocks) / point.seconds / 1e6 << "  " << point.stop << "\n"
+                  << std::defaultfloat << std::flush;
+    }
+}
+
+
+bool Simulate::run(const std::string& spec, Point& point) {
+    if (!Channel::create(spec, seed)) return false;
+    point.channel = spec;
+    auto start = std::chrono::steady_clock::now();
+
+    std::mutex mutex;
+    std::atomic<bool> done(false);
+    std::size_t groups = static_cast<std::size_t>(std::min<std::uint64_t>(batchGroups, maxBlocks / 64 / threads + 1));
+
+    std::vector<std::thread> workers;
+    for (unsigned t = 0; t < threads; ++t) {
+        workers.emplace_back([&, t] {
+            //Streams t<<4 (messages) and t<<4 | 8 (channel, which may use the next seven) never overlap
+            std::unique_ptr<Channel> channel = Channel::create(spec, seed, (static_cast<std::uint64_t>(t) << 4) | 8);
+            std::uint64_t messageCounter = 0;
+            std::vector<std::uint64_t> positions;
+
+            while (!done.load(std::memory_order_relaxed)) {
+                Point batch;
+                runGroups(*channel, messageCounter, static_cast<std::uint64_t>(t) << 4, groups, positions, batch);
+
+                std::lock_guard<std::mutex> lock(mutex);
+                if (done.load(std::memory_order_relaxed)) break;
+                point.blocks += batch.blocks;
+                point.flips += batch.flips;
+                point.bitErrors += batch.bitErrors;
+                point.blockErrors += batch.blockErrors;
+
+                wilson(point.blockErrors, point.blocks, point.bler);
+                double elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+                if (point.blockErrors > 0 && (point.bler[2] - point.bler[1]) / 2 <= precision * point.bler[0]) point.stop = "precision";
+                else if (point.bler[2] < floor) point.stop = "floor";
+                else if (maxSeconds > 0 && elapsed >= maxSeconds) point.stop = "time";
+                else if (point.blocks >= maxBlocks) point.stop = "blocks";
+                if (!point.stop.empty()) done.store(true, std::memory_order_relaxed);
+            }
+        });
+    }
+    for (std::thread& worker : workers) worker.join();
+
+    wilson(point.blockErrors, point.blocks, point.bler);
+    wilson(point.bitErrors, point.blocks * 4, point.ber);
+    point.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    return true;
+}
+
+void Simulate::runGroups(Channel& channel, std::uint64_t& messageCounter, std::uint64_t messages, std::size_t groups,
+                         std::vector<std::uint64_t>& positions, Point& point) const {
+    positions.clear();
+    channel.corrupt(static_cast<std::uint64_t>(groups) * 64, positions);
+    point.blocks += static_cast<std::uint64_t>(groups) * 64;
+    point.flips += positions.size();
+
+    Philox random(seed, messages);
+    std::size_t next = 0;
+    for (std::size_t group = 0; group < groups && next < positions.size(); ++group) {
+        //Error columns of this group; a group without flips decodes to itself
+        std::uint64_t end = static_cast<std::uint64_t>(group + 1) * 64 * 7;
+        if (positions[next] >= end) continue;
+        std::uint64_t error[7] = {};
+        for (; next < positions.size() && positions[next] < end; ++next) {
+            std::uint64_t bit = positions[next] - static_cast<std::uint64_t>(group) * 64 * 7;
+            error[bit % 7] ^= static_cast<std::uint64_t>(1) << (bit / 7);
+        }
+
+        //64 random messages, one per lane
+        Philox::Block low = random(messageCounter++);
+        Philox::Block high = random(messageCounter++);
+        std::uint64_t message[4] = {
+            (static_cast<std::uint64_t>(low[1]) << 32) | low[0], (static_cast<std::uint64_t>(low[3]) << 32) | low[2],
+            (static_cast<std::uint64_t>(high[1]) << 32) | high[0], (static_cast<std::uint64_t>(high[3]) << 32) | high[2]};
+
+        std::uint64_t word[7];
+        encodeSliced(message, word);
+        for (int j = 0; j < 7; ++j) word[j] ^= error[j];
+        correctSliced(word);
+
+        std::uint64_t wrong = 0;
+        for (int i = 0; i < 4; ++i) {
+            std::uint64_t diff = word[sliceDataColumn[i]] ^ message[i];
+            point.bitErrors += static_cast<std::uint64_t>(__builtin_popcountll(diff));
+            wrong |= diff;
+        }
+        point.blockErrors += static_cast<std::uint64_t>(__builtin_popcountll(wrong));
+    }
+}
+
+void Simulate::wilson(std::uint64_t successes, std::uint64_t trials, double out[3]) {
+    if (trials == 0) {
+        out[0] = out[1] = out[2] = 0;
+        return;
+    }
+    const double z = 1.959963984540054;
+    double n = static_cast<double>(trials);
+    double p = static_cast<double>(successes) / n;
+    double center = (p + z * z / (2 * n)) / (1 + z * z / n);
+    double half = z / (1 + z * z / n) * std::sqrt(p * (1 - p) / n + z * z / (4 * n * n));
+    out[0] = p;
+    out[1] = successes == 0 ? 0.0 : std::max(0.0, center - half);
+    out[2] = std::min(1.0, center + half);
+}
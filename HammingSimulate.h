@@ -0,0 +1,121 @@
+/* Colton Criswell and Zach Hamby
+ * Final Project - CS-300
+ */
+
+#ifndef HAMMING_SIMULATE_H
+#define HAMMING_SIMULATE_H
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+#include "Hamming.h"
+
+class Channel;
+
+/**
+ * @class Simulate
+ * @brief Derived class for Monte Carlo bit and block error rate simulation.
+ *
+ * Random messages are encoded, passed through a channel model and corrected, 64 codewords at a
+ * time: each of the seven codeword columns is one 64-bit word whose lanes are independent
+ * codewords, so encoding, syndrome and correction are a few dozen logic operations per 64 blocks.
+ * The bit-sliced code (Hamming::encodeSliced/correctSliced) is derived from the same generator
+ * matrix and syndrome table as the encoder and decoder. Every thread has its own Philox streams for messages and channel, and a point stops
+ * as soon as its block error rate is known to the requested relative precision, or is known to be
+ * below a floor (channels that cause no block errors, e.g. exact:1, would otherwise never stop
+ * early), or its time budget runs out.
+ */
+class Simulate : public Hamming {
+
+    public:
+        static const std::uint64_t defaultMaxBlocks = 10000000000ull; ///< Codewords per point without early stop
+        static const std::uint64_t defaultSeed = 0x5EED;              ///< Seed used when none is given
+        static constexpr double defaultFloor = 1e-8;                   ///< Block error rate below which a point stops
+        static constexpr double defaultMaxSeconds = 60;                ///< Wall time per point
+
+        /**
+         * @struct Point
+         * @brief Result for one channel.
+         */
+        struct Point {
+            std::string channel;           ///< Channel specification
+            std::uint64_t blocks = 0;      ///< Codewords simulated
+            std::uint64_t flips = 0;       ///< Bits flipped by the channel
+            std::uint64_t bitErrors = 0;   ///< Message bits still wrong after correction
+            std::uint64_t blockErrors = 0; ///< Messages with at least one wrong bit
+            double ber[3] = {0, 0, 0};     ///< Residual bit error rate: estimate, 95% interval low, high
+            double bler[3] = {0, 0, 0};    ///< Residual block error rate: estimate, 95% interval low, high
+            double seconds = 0;            ///< Wall time
+            std::string stop;              ///< Why it stopped: precision, floor, time or blocks
+        };
+
+        /**
+         * @brief Constructor for Simulate class; simulates and prints every channel.
+         * @param channels Channel specifications (see Channel::create), one point each.
+         * @param maxBlocks Codewords per point if the interval never gets tight enough.
+         * @param precision Stop once the 95% interval half-width is below this fraction of the block error rate.
+         * @param threads Number of worker threads (0 = one per core).
+         * @param seed Seed of messages and channels.
+         * @param floor Stop once the 95% interval's upper end of the block error rate is below this (0 = never).
+         * @param maxSeconds Stop a point after this much wall time (0 = no limit).
+         */
+        Simulate(std::vector<std::string> channels, std::uint64_t maxBlocks = defaultMaxBlocks, double precision = 0.05,
+                 unsigned threads = 0, std::uint64_t seed = defaultSeed, double floor = defaultFloor, double maxSeconds = defaultMaxSeconds);
+
+        /**
+         * @brief Destructor for Simulate class.
+         */
+        ~Simulate();
+
+        /**
+         * @brief Getter for the results.
+         * @return One point per channel, in order.
+         */
+        const std::vector<Point>& getResults() const;
+
+    private:
+        /**
+         * @brief Simulates every channel and prints a table.
+         */
+        void processFile() override;
+
+        /**
+         * @brief Simulates one channel on all threads.
+         * @param spec Channel specification.
+         * @param point Receives the counters and intervals.
+         * @return False if the specification is invalid.
+         */
+        bool run(const std::string& spec, Point& point);
+
+        /**
+         * @brief Runs 64 codewords per group through encoder, channel and decoder.
+         * @param channel This thread's channel.
+         * @param messageCounter Next counter of this thread's message stream.
+         * @param messages Philox stream number of this thread's messages.
+         * @param groups Number of 64-codeword groups.
+         * @param positions Scratch buffer for the flipped positions, reused between calls.
+         * @param point Counters to add to (blocks, flips, bitErrors, blockErrors).
+         */
+        void runGroups(Channel& channel, std::uint64_t& messageCounter, std::uint64_t messages, std::size_t groups,
+                       std::vector<std::uint64_t>& positions, Point& point) const;
+
+        /**
+         * @brief Wilson score interval of a binomial proportion.
+         * @param successes Observed events.
+         * @param trials Trials.
+         * @param out Receives estimate, 95% low and high.
+         */
+        static void wilson(std::uint64_t successes, std::uint64_t trials, double out[3]);
+
+        std::vector<std::string> channels; ///< Channel specifications
+        std::uint64_t maxBlocks;           ///< Codewords per point without early stop
+        double precision;                  ///< Relative half-width that stops a point
+        unsigned threads;                  ///< Number of worker threads
+        std::uint64_t seed;                ///< Seed of messages and channels
+        double floor;                      ///< Block error rate bound that stops a point
+        double maxSeconds;                 ///< Wall time that stops a point
+        std::vector<Point> results;        ///< One point per channel
+};
+
+#endif
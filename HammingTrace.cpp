@@ -0,0 +1,140 @@
+// Chrome trace recording (see HammingTrace.h)
+// Each thread owns a preallocated event array and a published count: the owner fills the next
+// slot, then release-stores the count, so a dump that acquire-loads the count reads only
+// finished events. Timestamps are steady_clock nanoseconds from the moment tracing was enabled
+
+#include <iostream>
+#include <fstream>
+#include <sstream>
+#include <atomic>
+#include <memory>
+#include <mutex>
+#include <vector>
+#include <unistd.h>
+#include "HammingTrace.h"
+
+namespace {
+    struct Event {
+        const char* name;
+        std::uint64_t begin;     //Nanoseconds since enable()
+        std::uint64_t duration;  //Nanoseconds
+        std::uint64_t chunk;     //Chunk sequence number, or Trace::noChunk
+    };
+
+    struct ThreadEvents {
+        std::size_t number = 0;                  //Order of the thread's first event; the trace's tid
+        std::string name;                        //Set by nameThread(), empty otherwise
+        std::vector<Event> events;               //Preallocated; never reallocated
+        std::atomic<std::size_t> count{0};       //Events published
+        std::atomic<std::uint64_t> dropped{0};   //Events lost to a full buffer
+    };
+
+    std::atomic<bool> recording{false};
+    std::size_t capacity = Trace::defaultEventsPerThread;
+    std::chrono::steady_clock::time_point origin;
+
+    std::mutex registryMutex;
+    std::vector<std::shared_ptr<ThreadEvents>> registry;  //Every thread that recorded, exited ones included
+
+    ThreadEvents& local() {
+        thread_local std::shared_ptr<ThreadEvents> events = [] {
+            auto created = std::make_shared<ThreadEvents>();
+            created->events.resize(capacity);
+            std::lock_guard<std::mutex> lock(registryMutex);
+            created->number = registry.size() + 1;
+            registry.push_back(created);
+            return created;
+        }();
+        return *events;
+    }
+
+    std::uint64_t sinceOrigin(std::chrono::steady_clock::time_point time) {
+        return static_cast<std::uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(time - origin).count());
+    }
+
+    //Chrome trace timestamps are microseconds; three decimals keep nanoseconds
+    void writeMicroseconds(std::ostream& out, std::uint64_t nanoseconds) {
+        out << nanoseconds / 1000 << "." << static_cast<char>('0' + nanoseconds / 100 % 10)
+            << static_cast<char>('0' + nanoseconds / 10 % 10) << static_cast<char>('0' + nanoseconds % 10);
+    }
+}
+
+
+void Trace::enable(std::size_t eventsPerThread) {
+    if (recording.load(std::memory_order_relaxed)) return;
+    capacity = eventsPerThread ? eventsPerThread : 1;
+    origin = std::chrono::steady_clock::now();
+    recording.store(true, std::memory_order_release);
+}
+
+bool Trace::enabled() {
+    return recording.load(std::memory_order_relaxed);
+}
+
+void Trace::record(const char* name, std::chrono::steady_clock::time_point begin, std::chrono::steady_clock::time_point end,
+                   std::uint64_t chunk) {
+    ThreadEvents& thread = local();
+    std::size_t at = thread.count.load(std::memory_order_relaxed);
+    if (at == thread.events.size()) {
+        thread.dropped.store(thread.dropped.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+        return;
+    }
+    std::uint64_t start = sinceOrigin(begin);
+    thread.events[at] = Event{name, start, sinceOrigin(end) - start, chunk};
+    thread.count.store(at + 1, std::memory_order_release);
+}
+
+void Trace::nameThread(const std::string& name) {
+    if (!enabled()) return;
+    ThreadEvents& thread = local();
+    std::lock_guard<std::mutex> lock(registryMutex);
+    thread.name = name;
+}
+
+
+void Trace::writeJson(std::ostream& out) {
+    std::vector<std::shared_ptr<ThreadEvents>> threads;
+    {
+        std::lock_guard<std::mutex> lock(registryMutex);
+        threads = registry;
+    }
+    long pid = static_cast<long>(getpid());
+
+    std::ostringstream json;
+    json << "{\"displayTimeUnit\":\"ns\",\"traceEvents\":[\n";
+    json << "{\"name\":\"process_name\",\"ph\":\"M\",\"pid\":" << pid << ",\"tid\":0,\"args\":{\"name\":\"hamming\"}}";
+    std::uint64_t dropped = 0;
+    for (const auto& thread : threads) {
+        std::string name;
+        {
+            std::lock_guard<std::mutex> lock(registryMutex);
+            name = thread->name.empty() ? "thread " + std::to_string(thread->number) : thread->name;
+        }
+        json << ",\n{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":" << pid << ",\"tid\":" << thread->number
+             << ",\"args\":{\"name\":\"" << name << "\"}}";
+
+        std::size_t count = thread->count.load(std::memory_order_acquire);
+        for (std::size_t i = 0; i < count; ++i) {
+            const Event& event = thread->events[i];
+            json << ",\n{\"name\":\"" << event.name << "\",\"ph\":\"X\",\"pid\":" << pid << ",\"tid\":" << thread->number << ",\"ts\":";
+            writeMicroseconds(json, event.begin);
+            json << ",\"dur\":";
+            writeMicroseconds(json, event.duration);
+            if (event.chunk != noChunk) json << ",\"args\":{\"chunk\":" << event.chunk << "}";
+            json << "}";
+        }
+        dropped += thread->dropped.load(std::memory_order_relaxed);
+    }
+    json << "\n],\"otherData\":{\"dropped_events\":" << dropped << "}}\n";
+    out << json.str() << std::flush;
+}
+
+bool Trace::dump(const std::string& path) {
+    std::ofstream out(path, std::ios::out | std::ios::trunc);
+    if (!out.is_open()) {
+        std::cerr << "Error creating output file: " << path << std::endl;
+        return false;
+    }
+    writeJson(out);
+    return true;
+}
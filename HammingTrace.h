@@ -0,0 +1,111 @@
+/* Colton Criswell and Zach Hamby
+ * Final Project - CS-300
+ */
+
+#ifndef HAMMING_TRACE_H
+#define HAMMING_TRACE_H
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <ostream>
+#include <string>
+
+/*
+ * Timeline of chunk stages (read, parse, encode, decode, inject, write, and the waits between
+ * pipeline stages) as Chrome trace JSON, viewable in Perfetto or chrome://tracing.
+ *
+ * Off until Trace::enable() (main --trace=<file.json>); a disabled scope costs one relaxed load.
+ * Events of a chunk carry its sequence number as args.chunk, so one chunk can be followed through
+ * its stages and across threads.
+ * Enabled, every thread appends complete events to its own fixed-size buffer and publishes them
+ * with one release store, so recording takes no lock; a full buffer drops further events and
+ * the dump says how many. The buffers are written out at exit.
+ */
+
+/**
+ * @class Trace
+ * @brief Per-thread event buffers, dumped as Chrome trace JSON.
+ */
+class Trace {
+
+    public:
+        static const std::size_t defaultEventsPerThread = 1 << 16; ///< Events kept per thread (32 bytes each)
+        static const std::uint64_t noChunk = ~std::uint64_t(0);    ///< Chunk of an event that belongs to none
+
+        /**
+         * @brief Turns recording on for every thread.
+         * @param eventsPerThread Capacity of each thread's buffer.
+         */
+        static void enable(std::size_t eventsPerThread = defaultEventsPerThread);
+
+        /**
+         * @brief Checks whether recording is on.
+         * @return True once enable() was called.
+         */
+        static bool enabled();
+
+        /**
+         * @brief Appends one complete event to the calling thread's buffer.
+         * @param name Event name; must be a string literal (only the pointer is kept).
+         * @param begin Start time.
+         * @param end End time.
+         * @param chunk Sequence number of the chunk the event worked on, or noChunk.
+         */
+        static void record(const char* name, std::chrono::steady_clock::time_point begin, std::chrono::steady_clock::time_point end,
+                           std::uint64_t chunk = noChunk);
+
+        /**
+         * @brief Names the calling thread in the timeline.
+         * @param name Thread name, e.g. "reader" or "codec 2".
+         */
+        static void nameThread(const std::string& name);
+
+        /**
+         * @brief Writes every thread's events as Chrome trace JSON.
+         * @param out Destination stream.
+         */
+        static void writeJson(std::ostream& out);
+
+        /**
+         * @brief Writes the trace to a file.
+         * @param path Destination.
+         * @return True if the file was written.
+         */
+        static bool dump(const std::string& path);
+};
+
+/**
+ * @class TraceScope
+ * @brief Records the lifetime of a block as one event when recording is on.
+ */
+class TraceScope {
+
+    public:
+        /**
+         * @brief Constructor for TraceScope class; starts the clock if recording is on.
+         * @param name Event name; must be a string literal.
+         * @param chunk Sequence number of the chunk the block works on, or Trace::noChunk.
+         */
+        explicit TraceScope(const char* name, std::uint64_t chunk = Trace::noChunk) : name(name), chunk(chunk), active(Trace::enabled()) {
+            if (active) begin = std::chrono::steady_clock::now();
+        }
+
+        /**
+         * @brief Destructor for TraceScope class; records the event.
+         */
+        ~TraceScope() {
+            if (active) Trace::record(name, begin, std::chrono::steady_clock::now(), chunk);
+        }
+
+        TraceScope(const TraceScope&) = delete;
+        TraceScope& operator=(const TraceScope&) = delete;
+
+    private:
+        const char* name;                              ///< Event name
+        std::uint64_t chunk;                           ///< Chunk sequence number, or Trace::noChunk
+        bool active;                                   ///< Whether recording was on at construction
+        std::chrono::steady_clock::time_point begin;   ///< Construction time
+};
+
+#endif
@@ -0,0 +1,133 @@
+/* Colton Criswell and Zach Hamby
+ * Final Project - CS-300
+ */
+
+#ifndef RING_BUFFER_H
+#define RING_BUFFER_H
+
+#include <atomic>
+#include <cstddef>
+#include <thread>
+#include <vector>
+
+/**
+ * @class SpscRing
+ * @brief Bounded lock-free single-producer/single-consumer queue.
+ * 
+ * Head and tail live on separate cache lines and each side caches the other's index, so a
+ * push or pop normally touches no shared cache line that the other thread is writing. A blocked
+ * push or pop spins briefly, then yields, then sleeps on the other side's index (a futex on
+ * Linux), so an idle stage costs no CPU while the one it waits for is stuck on I/O.
+ */
+template <typename T>
+class SpscRing {
+
+    public:
+        /**
+         * @brief Constructor for SpscRing class.
+         * @param capacity Minimum number of elements; rounded up to a power of two.
+         */
+        explicit SpscRing(std::size_t capacity) {
+            std::size_t size = 2;
+            while (size < capacity) size <<= 1;
+            slots.resize(size);
+            mask = size - 1;
+        }
+
+        SpscRing(const SpscRing&) = delete;
+        SpscRing& operator=(const SpscRing&) = delete;
+
+        /**
+         * @brief Adds an element if there is room (producer only).
+         * @param value The element.
+         * @return False if the ring is full.
+         */
+        bool tryPush(const T& value) {
+            std::size_t t = tail.load(std::memory_order_relaxed);
+            if (t - cachedHead == slots.size()) {
+                cachedHead = head.load(std::memory_order_acquire);
+                if (t - cachedHead == slots.size()) return false;
+            }
+            slots[t & mask] = value;
+            tail.store(t + 1, std::memory_order_release);
+            tail.notify_one();
+            return true;
+        }
+
+        /**
+         * @brief Removes the oldest element if there is one (consumer only).
+         * @param value Receives the element.
+         * @return False if the ring is empty.
+         */
+        bool tryPop(T& value) {
+            std::size_t h = head.load(std::memory_order_relaxed);
+            if (h == cachedTail) {
+                cachedTail = tail.load(std::memory_order_acquire);
+                if (h == cachedTail) return false;
+            }
+            value = slots[h & mask];
+            head.store(h + 1, std::memory_order_release);
+            head.notify_one();
+            return true;
+        }
+
+        /**
+         * @brief Adds an element, spinning, yielding and then sleeping while the ring is full.
+         * @param value The element.
+         */
+        void push(const T& value) {
+            for (unsigned spins = 0; !tryPush(value); ++spins) {
+                //The failed tryPush() just reloaded cachedHead; sleep until the consumer moves it
+                if (spins < sleepAfter) backoff(spins);
+                else head.wait(cachedHead, std::memory_order_acquire);
+            }
+        }
+
+        /**
+         * @brief Removes the oldest element, spinning, yielding and then sleeping while the ring is empty.
+         * @return The element.
+         */
+        T pop() {
+            T value;
+            for (unsigned spins = 0; !tryPop(value); ++spins) {
+                if (spins < sleepAfter) backoff(spins);
+                else tail.wait(cachedTail, std::memory_order_acquire);
+            }
+            return value;
+        }
+
+        /**
+         * @brief Approximate number of queued elements (safe from any thread).
+         * @return Elements pushed but not yet popped.
+         */
+        std::size_t depth() const {
+            return tail.load(std::memory_order_relaxed) - head.load(std::memory_order_relaxed);
+        }
+
+    private:
+        static const unsigned spinLimit = 64;   ///< Failed attempts answered with a pause instruction
+        static const unsigned sleepAfter = 128; ///< Failed attempts (spins, then yields) before sleeping
+
+        /**
+         * @brief Waits a little longer on every failed attempt.
+         * @param spins Failed attempts so far.
+         */
+        static void backoff(unsigned spins) {
+            if (spins < spinLimit) {
+#if defined(__x86_64__) || defined(__i386__)
+                __builtin_ia32_pause();
+#endif
+            } else {
+                std::this_thread::yield();
+            }
+        }
+
+        std::vector<T> slots;                        ///< Element storage
+        std::size_t mask = 0;                        ///< slots.size() - 1
+        alignas(64) std::atomic<std::size_t> head{0}; ///< Next slot to pop (written by the consumer)
+        std::size_t cachedTail = 0;                  ///< Consumer's copy of tail
+        alignas(64) std::atomic<std::size_t> tail{0}; ///< Next slot to push (written by the producer)
+        std::size_t cachedHead = 0;                  ///< Producer's copy of head
+};
+
+#endif
@@ -0,0 +1,163 @@
+// Work-stealing worker pool shared by the parallel encode/decode modes and the batch scheduler
+
+#include <algorithm>
+#include <iterator>
+#include <string>
+#include <utility>
+#include "ThreadPool.h"
+#include "HammingMetrics.h"
+#include "HammingTrace.h"
+
+namespace {
+    thread_local const ThreadPool* workerPool = nullptr; //Pool the calling thread works for
+    thread_local unsigned workerIndex = 0;               //Its queue index in that pool
+}
+
+
+//ThreadPool class constructor
+ThreadPool::ThreadPool(unsigned threads) {
+    unsigned count = resolveThreads(threads);
+    for (unsigned i = 0; i < count; ++i) {
+        queues.push_back(std::make_unique<Queue>());
+        queues.back()->tasks.reserve(queueCapacity);
+    }
+    for (unsigned i = 0; i < count; ++i) workers.emplace_back(&ThreadPool::run, this, i);
+}
+
+ThreadPool::~ThreadPool() {
+    wait();
+    {
+        std::lock_guard<std::mutex> lock(sleepMutex);
+        stopping = true;
+    }
+    wake.notify_all();
+    for (std::thread& worker : workers) worker.join();
+}
+
+
+void ThreadPool::submit(std::function<void()> task) {
+    submit(defaultGroup, std::move(task));
+}
+
+void ThreadPool::submit(Group& group, std::function<void()> task) {
+    group.pending.fetch_add(1, std::memory_order_relaxed);
+    group.queued.fetch_add(1, std::memory_order_relaxed);
+
+    //Workers keep their own sub-tasks local; outside submissions are spread round-robin
+    unsigned self = currentIndex();
+    unsigned target = self < queues.size() ? self : nextQueue.fetch_add(1, std::memory_order_relaxed) % queues.size();
+    {
+        Queue& queue = *queues[target];
+        std::lock_guard<std::mutex> lock(queue.mutex);
+        //Reuse the space of stolen tasks before growing the vector
+        if (queue.head != 0 && queue.tasks.size() == queue.tasks.capacity()) {
+            queue.tasks.erase(queue.tasks.begin(), queue.tasks.begin() + static_cast<std::ptrdiff_t>(queue.head));
+            queue.head = 0;
+        }
+        queue.tasks.push_back(Task{std::move(task), &group});
+    }
+    queued.fetch_add(1, std::memory_order_release);
+    Metrics::queue(MetricQueue::Pool, 1);
+
+    std::lock_guard<std::mutex> lock(sleepMutex);
+    wake.notify_all();
+}
+
+void ThreadPool::wait() {
+    wait(defaultGroup);
+}
+
+//Helping is limited to the group's own tasks: a worker waiting on one file's chunks that picked up
+//another file task could nest that file's wait in turn, without bound, each level holding its
+//file open and a stack frame
+void ThreadPool::wait(Group& group) {
+    unsigned self = currentIndex();
+    while (group.pending.load(std::memory_order_acquire) != 0) {
+        if (runOne(self, &group)) continue;
+
+        std::unique_lock<std::mutex> lock(sleepMutex);
+        wake.wait(lock, [&] {
+            return group.pending.load(std::memory_order_acquire) == 0 || group.queued.load(std::memory_order_acquire) != 0;
+        });
+    }
+}
+
+unsigned ThreadPool::size() const {
+    return static_cast<unsigned>(workers.size());
+}
+
+unsigned ThreadPool::resolveThreads(unsigned threads) {
+    if (threads == 0) threads = std::thread::hardware_concurrency();
+    return threads == 0 ? 1 : threads;
+}
+
+
+void ThreadPool::run(unsigned index) {
+    workerPool = this;
+    workerIndex = index;
+    Trace::nameThread("worker " + std::to_string(index + 1));
+    for (;;) {
+        if (runOne(index)) continue;
+
+        std::unique_lock<std::mutex> lock(sleepMutex);
+        wake.wait(lock, [this] { return stopping || queued.load(std::memory_order_acquire) != 0; });
+        if (stopping && queued.load(std::memory_order_acquire) == 0) return;
+    }
+}
+
+bool ThreadPool::runOne(unsigned self, Group* only) {
+    Task task;
+    bool found = false;
+    auto matches = [only](const Task& queuedTask) { return !only || queuedTask.group == only; };
+    auto drained = [](Queue& queue) {
+        if (queue.head == queue.tasks.size()) {
+            queue.tasks.clear();
+            queue.head = 0;
+        }
+    };
+
+    //Own deque first (newest task, still warm in cache)
+    if (self < queues.size()) {
+        Queue& own = *queues[self];
+        std::lock_guard<std::mutex> lock(own.mutex);
+        auto end = own.tasks.rend() - static_cast<std::ptrdiff_t>(own.head);
+        auto newest = std::find_if(own.tasks.rbegin(), end, matches);
+        if (newest != end) {
+            task = std::move(*newest);
+            own.tasks.erase(std::next(newest).base());
+            drained(own);
+            found = true;
+        }
+    }
+
+    //Then steal the oldest task of another worker
+    for (std::size_t k = 1; !found && k <= queues.size(); ++k) {
+        Queue& victim = *queues[(self + k) % queues.size()];
+        std::lock_guard<std::mutex> lock(victim.mutex);
+        auto front = victim.tasks.begin() + static_cast<std::ptrdiff_t>(victim.head);
+        auto oldest = std::find_if(front, victim.tasks.end(), matches);
+        if (oldest != victim.tasks.end()) {
+            task = std::move(*oldest);
+            if (oldest == front) ++victim.head;
+            else victim.tasks.erase(oldest);
+            drained(victim);
+            found = true;
+        }
+    }
+    if (!found) return false;
+
+    queued.fetch_sub(1, std::memory_order_acq_rel);
+    task.group->queued.fetch_sub(1, std::memory_order_acq_rel);
+    Metrics::queue(MetricQueue::Pool, -1);
+    task.run();
+
+    if (task.group->pending.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+        std::lock_guard<std::mutex> lock(sleepMutex);
+        wake.notify_all();
+    }
+    return true;
+}
+
+unsigned ThreadPool::currentIndex() const {
+    return workerPool == this ? workerIndex : static_cast<unsigned>(queues.size());
+}
@@ -0,0 +1,147 @@
+/* Colton Criswell and Zach Hamby
+ * Final Project - CS-300
+ */
+
+#ifndef THREAD_POOL_H
+#define THREAD_POOL_H
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+/**
+ * @class ThreadPool
+ * @brief Work-stealing pool of worker threads.
+ * 
+ * Each worker owns a deque: tasks submitted from a worker go to the back of its own deque and
+ * are taken LIFO, while idle workers steal FIFO from the front of the others. Tasks are tracked
+ * in groups, and waiting on a group runs that group's queued tasks instead of blocking, so a task
+ * may itself fan out into sub-tasks (e.g. one file task splitting into chunk tasks) on the same
+ * pool without the wait picking up unrelated tasks and nesting further.
+ */
+class ThreadPool {
+
+    public:
+        static const std::size_t queueCapacity = 64; ///< Tasks each deque holds before its vector grows
+
+        /**
+         * @class Group
+         * @brief Set of tasks that can be waited on together.
+         */
+        class Group {
+            friend class ThreadPool;
+            std::atomic<std::size_t> pending{0}; ///< Tasks of the group queued or running
+            std::atomic<std::size_t> queued{0};  ///< Tasks of the group still in a deque
+        };
+
+        /**
+         * @brief Constructor for ThreadPool class.
+         * @param threads Number of worker threads (0 = one per core).
+         */
+        ThreadPool(unsigned threads = 0);
+
+        /**
+         * @brief Destructor for ThreadPool class; waits for queued tasks and joins the workers.
+         */
+        ~ThreadPool();
+
+        ThreadPool(const ThreadPool&) = delete;
+        ThreadPool& operator=(const ThreadPool&) = delete;
+
+        /**
+         * @brief Queues a task in the pool's default group.
+         * @param task The task to run on a worker.
+         */
+        void submit(std::function<void()> task);
+
+        /**
+         * @brief Queues a task in a group.
+         * @param group The group the task belongs to.
+         * @param task The task to run on a worker.
+         */
+        void submit(Group& group, std::function<void()> task);
+
+        /**
+         * @brief Runs or waits for tasks until the default group is empty.
+         */
+        void wait();
+
+        /**
+         * @brief Runs the group's own queued tasks, or waits, until the group is empty.
+         * @param group The group to wait for.
+         */
+        void wait(Group& group);
+
+        /**
+         * @brief Getter for the number of workers.
+         * @return The number of worker threads.
+         */
+        unsigned size() const;
+
+        /**
+         * @brief Resolves a requested thread count.
+         * @param threads Requested count (0 = one per core).
+         * @return The number of threads to use (at least 1).
+         */
+        static unsigned resolveThreads(unsigned threads);
+
+    private:
+        /**
+         * @struct Task
+         * @brief A queued task and the group it counts against.
+         */
+        struct Task {
+            std::function<void()> run; ///< The work
+            Group* group;              ///< Group to signal when done
+        };
+
+        /**
+         * @struct Queue
+         * @brief One worker's deque.
+         *
+         * A vector with a moving front rather than std::deque, which allocates and frees a node every
+         * few tasks as they flow through: the vector keeps its capacity when it drains, so queueing
+         * tasks does not allocate once the pool has warmed up.
+         */
+        struct Queue {
+            std::mutex mutex;          ///< Guards tasks and head
+            std::vector<Task> tasks;   ///< Tasks from head on are queued: owner pops the back, thieves take the front
+            std::size_t head = 0;      ///< Index of the oldest queued task
+        };
+
+        /**
+         * @brief Worker loop.
+         * @param index The worker's queue index.
+         */
+        void run(unsigned index);
+
+        /**
+         * @brief Pops a task from the caller's own deque or steals one, and runs it.
+         * @param self Queue index of the caller (size() for threads outside the pool).
+         * @param only Group the task must belong to (nullptr = any).
+         * @return False if no deque held a matching task.
+         */
+        bool runOne(unsigned self, Group* only = nullptr);
+
+        /**
+         * @brief Queue index of the calling thread.
+         * @return Its worker index, or size() if it is not a worker of this pool.
+         */
+        unsigned currentIndex() const;
+
+        std::vector<std::unique_ptr<Queue>> queues; ///< One deque per worker
+        std::vector<std::thread> workers;           ///< Worker threads
+        std::atomic<std::size_t> queued{0};         ///< Tasks sitting in any deque
+        std::atomic<unsigned> nextQueue{0};         ///< Round-robin target for outside submissions
+        std::mutex sleepMutex;                      ///< Guards sleeping and stopping
+        std::condition_variable wake;               ///< Signalled on new tasks and finished groups
+        bool stopping = false;                      ///< Set by the destructor
+        Group defaultGroup;                         ///< Group used by submit(task)/wait()
+};
+
+#endif
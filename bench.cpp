@@ -0,0 +1,205 @@
+// Benchmark driver: parses the options, runs the suite and writes the JSON results
+// Built by `make bench` from optimized objects kept apart from the debug build; exits 1 if an
+// in-memory encode or decode kernel allocated once warmed up, if a result allocated more per run
+// on a larger input, or on errors, and 2 if a result regressed against the --baseline results by
+// more than its --threshold (`make bench-check`)
+
+#include <iostream>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <vector>
+#include <cstdlib>
+#include <map>
+#include <sched.h>
+#include "HammingBench.h"
+
+//Prints the options
+static void printUsage(const char* program) {
+    std::cerr << "Usage: " << program << " [--sizes=1K,64K,1M,16M] [--kernels=encode,decode,inject,scrub]\n"
+              << "       " << std::string(std::string(program).size(), ' ')
+              << " [--formats=text,packed,sliced,text-file,packed-file] [--min-time=0.2]\n"
+              << "       " << std::string(std::string(program).size(), ' ')
+              << " [--eigen-max=16M] [--serial-max=1M] [--chunk=4M] [--dir=.] [--seed=S]\n"
+              << "       " << std::string(std::string(program).size(), ' ')
+              << " [--json=results.json] [--passes=N] [--cpu=K]\n"
+              << "       " << std::string(std::string(program).size(), ' ')
+              << " [--baseline=base.json [--threshold=5,text-file:10] [--retries=2 | --compare=results.json]]\n";
+}
+
+//Splits a comma separated list
+static std::vector<std::string> splitList(const std::string& list) {
+    std::vector<std::string> items;
+    std::stringstream stream(list);
+    std::string item;
+    while (std::getline(stream, item, ',')) {
+        if (!item.empty()) items.push_back(item);
+    }
+    return items;
+}
+
+//Parses a byte count with an optional K, M or G suffix (powers of 1024); 0 if invalid
+static std::size_t parseSize(const std::string& text) {
+    char* end;
+    double value = std::strtod(text.c_str(), &end);
+    std::string suffix(end);
+    double scale = suffix.empty() ? 1 : suffix == "K" ? 1 << 10 : suffix == "M" ? 1 << 20 : suffix == "G" ? 1 << 30 : 0;
+    return value > 0 ? static_cast<std::size_t>(value * scale) : 0;
+}
+
+//Parses "percent[,name:percent...]" into the thresholds of Benchmark::compare(); false if invalid
+static bool parseThresholds(const std::string& list, std::map<std::string, double>& thresholds) {
+    for (const std::string& item : splitList(list)) {
+        std::size_t colon = item.find(':');
+        std::string name = colon == std::string::npos ? "" : item.substr(0, colon);
+        std::string percent = colon == std::string::npos ? item : item.substr(colon + 1);
+        char* end;
+        double value = std::strtod(percent.c_str(), &end);
+        if (percent.empty() || *end != '\0' || value < 0) return false;
+        thresholds[name] = value;
+    }
+    return true;
+}
+
+//Compares results with the baseline, measuring each result that looks regressed again (alone, up
+//to retries times, keeping the fastest) so that one disturbed run does not fail the check; 2 if
+//anything still regressed, 1 on errors
+static int checkBaseline(const std::string& baselinePath, std::vector<Benchmark::Result> current,
+                         const std::map<std::string, double>& thresholds, const Benchmark::Options& options, unsigned retries) {
+    std::vector<Benchmark::Result> baseline;
+    if (!Benchmark::readJson(baselinePath, baseline)) return 1;
+    std::ostringstream table;
+    std::vector<Benchmark::Result> regressions = Benchmark::compare(baseline, current, thresholds, table);
+    for (unsigned retry = 1; retry <= retries && !regressions.empty(); ++retry) {
+        std::cerr << "Measuring " << regressions.size() << " results that look regressed again (retry " << retry << " of " << retries << "):\n";
+        for (const Benchmark::Result& regressed : regressions) {
+            Benchmark::Options again = options;
+            again.kernels = {regressed.kernel};
+            again.formats = {regressed.format};
+            again.sizes = {regressed.bytes};
+            Benchmark benchmark(again);
+            for (const Benchmark::Result& result : benchmark.getResults()) {
+                for (Benchmark::Result& kept : current) {
+                    if (kept.kernel == result.kernel && kept.backend == result.backend && kept.format == result.format
+                        && kept.bytes == result.bytes && result.seconds < kept.seconds) {
+                        kept = result;
+                    }
+                }
+            }
+        }
+        table.str("");
+        regressions = Benchmark::compare(baseline, current, thresholds, table);
+    }
+
+    std::cerr << table.str();
+    if (!regressions.empty()) {
+        std::cerr << regressions.size() << " of " << baseline.size() << " results regressed against or are missing from " << baselinePath << ".\n";
+        return 2;
+    }
+    std::cerr << "No regressions against " << baselinePath << ".\n";
+    return 0;
+}
+
+int main(int argc, char* argv[]) {
+    Benchmark::Options options;
+    std::string json, baseline, compare;
+    std::map<std::string, double> thresholds = {{"", 5}};
+    int cpu = -1;
+    unsigned retries = 2;
+
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        std::string value = arg.substr(arg.find('=') + 1);
+        if (arg.rfind("--sizes=", 0) == 0) {
+            options.sizes.clear();
+            for (const std::string& size : splitList(value)) options.sizes.push_back(parseSize(size));
+        } else if (arg.rfind("--kernels=", 0) == 0) {
+            options.kernels = splitList(value);
+        } else if (arg.rfind("--formats=", 0) == 0) {
+            options.formats = splitList(value);
+        } else if (arg.rfind("--min-time=", 0) == 0) {
+            options.minTime = std::strtod(value.c_str(), nullptr);
+        } else if (arg.rfind("--eigen-max=", 0) == 0) {
+            options.eigenMax = parseSize(value);
+        } else if (arg.rfind("--serial-max=", 0) == 0) {
+            options.serialMax = parseSize(value);
+        } else if (arg.rfind("--chunk=", 0) == 0) {
+            options.chunkSize = parseSize(value);
+        } else if (arg.rfind("--dir=", 0) == 0) {
+            options.directory = value;
+        } else if (arg.rfind("--seed=", 0) == 0) {
+            options.seed = std::strtoull(value.c_str(), nullptr, 0);
+        } else if (arg.rfind("--json=", 0) == 0) {
+            json = value;
+        } else if (arg.rfind("--passes=", 0) == 0) {
+            options.passes = static_cast<unsigned>(std::strtoul(value.c_str(), nullptr, 10));
+        } else if (arg.rfind("--cpu=", 0) == 0) {
+            cpu = std::atoi(value.c_str());
+        } else if (arg.rfind("--baseline=", 0) == 0) {
+            baseline = value;
+        } else if (arg.rfind("--threshold=", 0) == 0) {
+            if (!parseThresholds(value, thresholds)) {
+                std::cerr << "Error: thresholds are percentages, optionally prefixed by a kernel, backend or format name and a colon." << std::endl;
+                return 1;
+            }
+        } else if (arg.rfind("--retries=", 0) == 0) {
+            retries = static_cast<unsigned>(std::strtoul(value.c_str(), nullptr, 10));
+        } else if (arg.rfind("--compare=", 0) == 0) {
+            compare = value;
+        } else {
+            printUsage(argv[0]);
+            return 1;
+        }
+    }
+    for (std::size_t size : options.sizes) {
+        if (size == 0) {
+            std::cerr << "Error: sizes must be positive byte counts (K, M and G suffixes allowed)." << std::endl;
+            return 1;
+        }
+    }
+
+    //Comparing two stored result files runs nothing
+    if (!compare.empty()) {
+        if (baseline.empty()) {
+            std::cerr << "Error: --compare needs a --baseline to compare with." << std::endl;
+            return 1;
+        }
+        std::vector<Benchmark::Result> current;
+        if (!Benchmark::readJson(compare, current)) return 1;
+        return checkBaseline(baseline, current, thresholds, options, 0);
+    }
+
+    //One CPU for the whole run (worker threads inherit it): no migrations, and a core that a
+    //quiet system leaves alone keeps the spread between passes small
+    if (cpu >= 0) {
+        cpu_set_t set;
+        CPU_ZERO(&set);
+        CPU_SET(cpu, &set);
+        if (sched_setaffinity(0, sizeof(set), &set) != 0) {
+            std::cerr << "Warning: could not pin to CPU " << cpu << "; running unpinned." << std::endl;
+        }
+    }
+
+    //Results are written either way; a kernel that allocates in steady state, or more on larger
+    //inputs, fails the run
+    Benchmark benchmark(options);
+    bool allocationFree = benchmark.allocationFree();
+    bool allocationsBounded = benchmark.allocationsBounded();
+    int status = allocationFree && allocationsBounded ? 0 : 1;
+    if (json.empty()) {
+        benchmark.writeJson(std::cout);
+    } else {
+        std::ofstream out(json, std::ios::out | std::ios::trunc);
+        if (!out.is_open()) {
+            std::cerr << "Error creating output file: " << json << std::endl;
+            return 1;
+        }
+        benchmark.writeJson(out);
+        std::cerr << "Results written to " << json << ".\n";
+    }
+    if (!baseline.empty()) {
+        int check = checkBaseline(baseline, benchmark.getResults(), thresholds, options, retries);
+        if (check) status = check;
+    }
+    return status;
+}
@@ -3,10 +3,295 @@
 #include <string>
 #include <cstdlib>
 #include <ctime>
+#include <iterator>
 #include "Hamming.h"
+#include "HammingAlloc.h"
+#include "HammingAsync.h"
+#include "HammingDaemon.h"
+#include "HammingErrorMap.h"
+#include "HammingLatency.h"
+#include "HammingMetrics.h"
+#include "HammingChannel.h"
+#include "HammingShm.h"
+#include "HammingTrace.h"
+#include "HammingSimulate.h"
 #include "Eigen/Dense"
 
-int main() {
+//Prints the command line modes
+static void printUsage(const char* program) {
+    std::cerr << "Usage: " << program << "                                  (run the test1..test5 demo)\n"
+              << "       " << program << " errencode <file> [seed] [channel] [plain|encoded]  (encode through a channel, default exact:1)\n"
+              << "       " << program << " errmap <map.hme> <blocks> [seed] [channel]  (save a channel's flips as a sparse error map)\n"
+              << "       " << program << " errapply <file> <map.hme> [plain|encoded]   (write _e_out.txt with the map applied)\n"
+              << "       " << program << " errdecode <file_out.txt> <map.hme>          (decode a clean encoding with the map applied)\n"
+              << "       " << program << " errreplay <file_out.txt|file.hmc> <faults.txt>  (replay recorded bit flips onto stored data)\n"
+              << "       " << program << " roundtrip <file>... [--channel=C] [--seed=S]  (fused encode/channel/decode/compare)\n"
+              << "       " << program << " decode <file_out.txt> [quiet|summary|trace]  (serial decode; trace prints every record)\n"
+              << "       " << program << " range <file> <offset> <length>   (decode a byte range to stdout)\n"
+              << "       " << program << " pack <file> [chunkSize] [--no-crc]   (encode into a packed .hmc container)\n"
+              << "       " << program << " unpack <file.hmc>                    (decode and verify a packed container)\n"
+              << "       " << program << " scrub <file>                         (fix correctable errors in place)\n"
+              << "       " << program << " pencode <file> [threads]             (multi-threaded encode to _out.txt)\n"
+              << "       " << program << " pdecode <file> [threads]             (multi-threaded decode to _decoded.txt)\n"
+              << "       " << program << " batch <manifest> [operation] [threads]  (process a list of files)\n"
+              << "       " << program << " pipe <encode|decode> <file> [codecThreads]  (streaming reader/codec/writer pipeline)\n"
+              << "       " << program << " async <encode|decode> <file>...     (many streams on one thread with coroutines)\n"
+              << "       " << program << " daemon <socket> [threads]            (serve requests on a Unix domain socket)\n"
+              << "       " << program << " client <socket> <encode|decode|scrub> <file|->  (send a path, or stdin with -)\n"
+              << "       " << program << " client <socket> latency              (the daemon's latency histograms as JSON)\n"
+              << "       " << program << " shm-serve <name> [slots] [slotSize]  (encode slots of a shared memory ring until Ctrl-C)\n"
+              << "       " << program << " shm-encode <name> <in> <out>        (stream a file through a served ring; several may run at once)\n"
+              << "       " << program << " simulate [--blocks=N] [--precision=r] [--floor=p] [--max-time=s] [--threads=T] [--seed=S] <channel>...\n"
+              << "       " << program << "                                       (Monte Carlo residual BER/BLER per channel)\n"
+              << "Any mode also takes --latency=<file> (.json for JSON, - for stderr) to record per-call latency histograms,\n"
+              << "--metrics=<file> [--metrics-interval=seconds] to keep a Prometheus text file of live counters,\n"
+              << "and --trace=<file.json> to write a Chrome trace of chunk stages at exit.\n";
+}
+
+//Where --latency= and --trace= asked for their output to be written at exit
+static std::string latencyPath;
+static std::string tracePath;
+
+int main(int argc, char* argv[]) {
+    //--latency=, --metrics= and --trace= may appear anywhere; they are removed before the mode is parsed
+    std::string metricsPath;
+    unsigned metricsInterval = Metrics::defaultInterval;
+    int kept = 1;
+    for (int a = 1; a < argc; ++a) {
+        std::string arg = argv[a];
+        if (arg.rfind("--latency=", 0) == 0) latencyPath = arg.substr(10);
+        else if (arg.rfind("--metrics=", 0) == 0) metricsPath = arg.substr(10);
+        else if (arg.rfind("--trace=", 0) == 0) tracePath = arg.substr(8);
+        else if (arg.rfind("--metrics-interval=", 0) == 0) metricsInterval = static_cast<unsigned>(std::strtoul(arg.c_str() + 19, nullptr, 10));
+        else argv[kept++] = argv[a];
+    }
+    argc = kept;
+    if (!latencyPath.empty()) {
+        Latency::enable();
+        std::atexit([] { Latency::dump(latencyPath); });
+    }
+    if (!metricsPath.empty()) Metrics::enable(metricsPath, metricsInterval);
+    if (AllocTracker::tracking) {
+        //Counting without a file when --metrics= was not given, for the per-MB rate
+        Metrics::enable("");
+        std::atexit([] { AllocTracker::report(std::cerr, Metrics::bytesIn()); });
+    }
+    if (!tracePath.empty()) {
+        Trace::enable();
+        Trace::nameThread("main");
+        std::atexit([] { Trace::dump(tracePath); });
+    }
+
+    if (argc > 1) {
+        std::string mode = argv[1];
+
+        if (mode == "errencode" && argc >= 3 && argc <= 6) {
+            ErrorEncode errorEncode(argv[2], argc >= 4 ? std::strtoull(argv[3], nullptr, 0) : ErrorEncode::defaultSeed,
+                                    argc >= 5 ? argv[4] : "exact:1",
+                                    argc == 6 && std::string(argv[5]) == "encoded" ? ErrorEncode::Input::Encoded : ErrorEncode::Input::Plain);
+            return 0;
+        }
+
+        if (mode == "errmap" && argc >= 4 && argc <= 6) {
+            std::unique_ptr<Channel> channel = Channel::create(argc == 6 ? argv[5] : "exact:1",
+                                                               argc >= 5 ? std::strtoull(argv[4], nullptr, 0) : ErrorEncode::defaultSeed);
+            if (!channel) return 1;
+            ErrorMap errors;
+            errors.record(*channel, static_cast<std::uint64_t>(std::strtod(argv[3], nullptr)));
+            if (!errors.save(argv[2])) return 1;
+            std::cout << "Error map written to " << argv[2] << ": " << errors.getEntries().size() << " corrupted blocks, "
+                      << errors.countFlips() << " bits flipped in " << errors.getBlocks() << " blocks.\n";
+            return 0;
+        }
+
+        if ((mode == "errapply" && (argc == 4 || argc == 5)) || (mode == "errdecode" && argc == 4)) {
+            ErrorMap errors;
+            if (!errors.load(argv[3])) return 1;
+            if (mode == "errdecode") {
+                OverlayDecode overlayDecode(argv[2], errors);
+            } else {
+                ErrorEncode errorEncode(argv[2], errors,
+                                        argc == 5 && std::string(argv[4]) == "encoded" ? ErrorEncode::Input::Encoded : ErrorEncode::Input::Plain);
+            }
+            return 0;
+        }
+
+        if (mode == "errreplay" && argc == 4) {
+            FaultMapReader faults(argv[3]);
+            if (!faults.isOpen()) return 1;
+            ErrorEncode errorEncode(argv[2], faults);
+            return faults.failed() || errorEncode.replayFailed() ? 1 : 0;
+        }
+
+        if (mode == "roundtrip" && argc >= 3) {
+            std::string channel = "exact:1";
+            std::uint64_t seed = ErrorEncode::defaultSeed;
+            std::vector<std::string> files;
+            for (int a = 2; a < argc; ++a) {
+                std::string arg = argv[a];
+                if (arg.rfind("--channel=", 0) == 0) channel = arg.substr(10);
+                else if (arg.rfind("--seed=", 0) == 0) seed = std::strtoull(arg.c_str() + 7, nullptr, 0);
+                else files.push_back(arg);
+            }
+            bool clean = true, failed = false;
+            for (const std::string& file : files) {
+                RoundTrip roundTrip(file, channel, seed);
+                failed = failed || roundTrip.getSummary().failed;
+                clean = clean && roundTrip.getSummary().byteErrors == 0;
+            }
+            return failed ? 1 : clean ? 0 : 2;
+        }
+
+        if (mode == "decode" && (argc == 3 || argc == 4)) {
+            std::string level = argc == 4 ? argv[3] : "summary";
+            if (level != "quiet" && level != "summary" && level != "trace") {
+                printUsage(argv[0]);
+                return 1;
+            }
+            Decode decode(argv[2], level == "quiet" ? Decode::Verbosity::Quiet
+                                   : level == "trace" ? Decode::Verbosity::Trace : Decode::Verbosity::Summary);
+            return 0;
+        }
+
+        if (mode == "range" && argc == 5) {
+            std::string decoded = decodeRange(argv[2], std::strtoull(argv[3], nullptr, 10), std::strtoull(argv[4], nullptr, 10));
+            std::cout.write(decoded.data(), decoded.size());
+            return 0;
+        }
+
+        if (mode == "pack" && argc >= 3 && argc <= 5) {
+            std::uint32_t chunkSize = PackedEncode::defaultChunkSize;
+            bool withCrc = true;
+            for (int a = 3; a < argc; ++a) {
+                if (std::string(argv[a]) == "--no-crc") withCrc = false;
+                else chunkSize = static_cast<std::uint32_t>(std::strtoul(argv[a], nullptr, 10));
+            }
+            PackedEncode packedEncode(argv[2], chunkSize, withCrc);
+            return 0;
+        }
+
+        if (mode == "unpack" && argc == 3) {
+            PackedDecode packedDecode(argv[2]);
+            return packedDecode.getFailedChunks().empty() ? 0 : 2;
+        }
+
+        if (mode == "scrub" && argc == 3) {
+            Scrub scrub(argv[2]);
+            return scrub.getSummary().failedChunks == 0 ? 0 : 2;
+        }
+
+        if (mode == "pencode" && (argc == 3 || argc == 4)) {
+            unsigned threads = argc == 4 ? static_cast<unsigned>(std::strtoul(argv[3], nullptr, 10)) : 0;
+            ParallelEncode parallelEncode(argv[2], threads);
+            return 0;
+        }
+
+        if (mode == "pdecode" && (argc == 3 || argc == 4)) {
+            unsigned threads = argc == 4 ? static_cast<unsigned>(std::strtoul(argv[3], nullptr, 10)) : 0;
+            ParallelDecode parallelDecode(argv[2], threads);
+            return 0;
+        }
+
+        if (mode == "batch" && argc >= 3 && argc <= 5) {
+            std::string operation = argc >= 4 ? argv[3] : "encode";
+            unsigned threads = argc == 5 ? static_cast<unsigned>(std::strtoul(argv[4], nullptr, 10)) : 0;
+            Batch batch(argv[2], operation, threads);
+            return batch.getFailures() == 0 ? 0 : 2;
+        }
+
+        if (mode == "pipe" && (argc == 4 || argc == 5)) {
+            std::string direction = argv[2];
+            unsigned threads = argc == 5 ? static_cast<unsigned>(std::strtoul(argv[4], nullptr, 10)) : 0;
+            if (direction == "encode" || direction == "decode") {
+                Pipeline pipeline(argv[3], direction == "encode" ? Pipeline::Mode::Encode : Pipeline::Mode::Decode, threads);
+                return 0;
+            }
+        }
+
+        if (mode == "async" && argc >= 4) {
+            std::string direction = argv[2];
+            if (direction == "encode" || direction == "decode") {
+                Scheduler scheduler;
+                AsyncCodec codec(scheduler);
+                for (int a = 3; a < argc; ++a) {
+                    scheduler.spawn(direction == "encode" ? codec.encodeFile(argv[a]) : codec.decodeFile(argv[a]));
+                }
+                scheduler.run();
+                return codec.getFailures() ? 1 : 0;
+            }
+        }
+
+        if (mode == "daemon" && (argc == 3 || argc == 4)) {
+            unsigned threads = argc == 4 ? static_cast<unsigned>(std::strtoul(argv[3], nullptr, 10)) : 0;
+            Daemon daemon(argv[2], threads);
+            return 0;
+        }
+
+        if (mode == "client" && (argc == 5 || (argc == 4 && std::string(argv[3]) == "latency"))) {
+            std::string operation = argv[3];
+            std::string target = argc == 5 ? argv[4] : "";
+            DaemonOp op = operation == "decode" ? DaemonOp::Decode : operation == "scrub" ? DaemonOp::Scrub
+                        : operation == "latency" ? DaemonOp::Latency : DaemonOp::Encode;
+            DaemonClient client(argv[2]);
+            if (!client.isConnected()) {
+                std::cerr << "Error connecting to daemon at " << argv[2] << std::endl;
+                return 1;
+            }
+
+            //"-" sends stdin inline and prints the result; anything else is a path on the daemon's host
+            std::string payload = target;
+            DaemonPayload kind = DaemonPayload::Path;
+            if (target == "-") {
+                payload.assign(std::istreambuf_iterator<char>(std::cin), std::istreambuf_iterator<char>());
+                kind = DaemonPayload::Inline;
+            }
+
+            std::string result;
+            int status = client.call(op, kind, payload, result);
+            if (status != 0) {
+                std::cerr << "Error: daemon returned status " << status << (result.empty() ? "" : ": " + result) << std::endl;
+                return 1;
+            }
+            std::cout << result;
+            if (kind == DaemonPayload::Path && op != DaemonOp::Latency) std::cout << "\n";
+            return 0;
+        }
+
+        if (mode == "shm-serve" && argc >= 3 && argc <= 5) {
+            std::uint32_t slots = argc >= 4 ? static_cast<std::uint32_t>(std::strtoul(argv[3], nullptr, 10)) : ShmCodec::defaultSlotCount;
+            std::uint32_t slotSize = argc == 5 ? static_cast<std::uint32_t>(std::strtoul(argv[4], nullptr, 10)) : ShmCodec::defaultSlotSize;
+            ShmCodec shmCodec(argv[2], slots, slotSize);
+            return 0;
+        }
+
+        if (mode == "shm-encode" && argc == 5) {
+            return shmEncodeFile(argv[2], argv[3], argv[4]) ? 0 : 1;
+        }
+
+        if (mode == "simulate" && argc >= 3) {
+            std::vector<std::string> channels;
+            std::uint64_t maxBlocks = Simulate::defaultMaxBlocks, seed = Simulate::defaultSeed;
+            double precision = 0.05, floor = Simulate::defaultFloor, maxSeconds = Simulate::defaultMaxSeconds;
+            unsigned threads = 0;
+            for (int a = 2; a < argc; ++a) {
+                std::string arg = argv[a];
+                std::string value = arg.substr(arg.find('=') + 1);
+                if (arg.rfind("--blocks=", 0) == 0) maxBlocks = static_cast<std::uint64_t>(std::strtod(value.c_str(), nullptr));
+                else if (arg.rfind("--precision=", 0) == 0) precision = std::strtod(value.c_str(), nullptr);
+                else if (arg.rfind("--threads=", 0) == 0) threads = static_cast<unsigned>(std::strtoul(value.c_str(), nullptr, 10));
+                else if (arg.rfind("--seed=", 0) == 0) seed = std::strtoull(value.c_str(), nullptr, 0);
+                else if (arg.rfind("--floor=", 0) == 0) floor = std::strtod(value.c_str(), nullptr);
+                else if (arg.rfind("--max-time=", 0) == 0) maxSeconds = std::strtod(value.c_str(), nullptr);
+                else channels.push_back(arg);
+            }
+            Simulate simulate(channels, maxBlocks, precision, threads, seed, floor, maxSeconds);
+            return simulate.getResults().size() == channels.size() ? 0 : 1;
+        }
+
+        printUsage(argv[0]);
+        return 1;
+    }
+
     for (int i = 1; i <= 5; ++i) {
         //Generate Filename
         std::string fileName = "test" + std::to_string(i);
@@ -16,7 +301,7 @@ int main() {
         Encode encoder1(fileName + ".txt");  
 
         std::cout << "_____ 2. Start Error Encoder _____\n";
-        ErrorEncode errorEncode2(fileName + ".txt"); //also calls Encode processFile()
+        ErrorEncode errorEncode2(encoder1); //reuses the codewords of encoder1
 
         std::cout << "________ 3. Start Decoder(No Errors) ________\n";
         Decode decode3(fileName + "_out.txt");